@@ -315,6 +315,11 @@ internal class AndroidNavigator(private val instance: WebView) : Navigator {
         instance.loadUrl(url)
     }
 
+    override fun loadHtml(html: String, baseUrl: String?): Unit {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "loadHtml: length=${html.length} baseUrl=$baseUrl")
+        instance.loadDataWithBaseURL(baseUrl, html, "text/html", "utf-8", null)
+    }
+
     internal companion object {
         private const val TAG = "AndroidWebViewNavigator"
     }
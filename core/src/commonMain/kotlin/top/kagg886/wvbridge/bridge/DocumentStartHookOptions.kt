@@ -0,0 +1,70 @@
+package top.kagg886.wvbridge.bridge
+
+/**
+ * Restricts where a document-start hook registered with
+ * [JavaScriptBridge.registerDocumentStartHook] runs.
+ *
+ * URL patterns are matched against the full document URL, with `*` matching any run of
+ * characters, for example `https://*.example.com/*`. WebKitGTK interprets them as WebKit URL match
+ * patterns, so write them in `<scheme>://<host>/<path>` form.
+ *
+ * Backends with native support skip frames that do not match without parsing the script:
+ * WebKitGTK applies all options natively, and iOS applies [mainFrameOnly] natively. Elsewhere the
+ * script is wrapped in a guard that checks the options before running. A wrapped script is
+ * placed in a block, so its top-level `let`, `const`, and `class` declarations are not visible to
+ * other scripts.
+ *
+ * @property mainFrameOnly Runs the hook only in the top-level document, not in iframes.
+ * @property allowedUrls When not empty, runs the hook only in documents matching one of these
+ * patterns.
+ * @property blockedUrls Never runs the hook in documents matching one of these patterns.
+ */
+public data class DocumentStartHookOptions(
+    val mainFrameOnly: Boolean = false,
+    val allowedUrls: List<String> = emptyList(),
+    val blockedUrls: List<String> = emptyList(),
+) {
+    /** Whether these options restrict the hook at all. */
+    internal val isDefault: Boolean
+        get() = !mainFrameOnly && allowedUrls.isEmpty() && blockedUrls.isEmpty()
+
+    public companion object {
+        /** Runs the hook in every frame of every document. */
+        public val Default: DocumentStartHookOptions = DocumentStartHookOptions()
+    }
+}
+
+/**
+ * Wraps [script] so it only runs where these options allow. The main-frame check is left out when
+ * [checkMainFrame] is `false` because the backend already applies it.
+ */
+internal fun DocumentStartHookOptions.guardScript(script: String, checkMainFrame: Boolean = true): String {
+    val conditions = buildList {
+        if (checkMainFrame && mainFrameOnly) add("window === window.top")
+        if (allowedUrls.isNotEmpty()) add(allowedUrls.toUrlRegExp() + ".test(location.href)")
+        if (blockedUrls.isNotEmpty()) add("!" + blockedUrls.toUrlRegExp() + ".test(location.href)")
+    }
+    if (conditions.isEmpty()) return script
+
+    return "if (${conditions.joinToString(" && ")}) {\n$script\n}"
+}
+
+/**
+ * Builds a JavaScript `RegExp` literal matching any of these `*` patterns against a whole URL.
+ */
+private fun List<String>.toUrlRegExp(): String = joinToString("|", prefix = "/^(?:", postfix = ")$/") { pattern ->
+    pattern.split('*').joinToString(".*") { part ->
+        buildString {
+            for (char in part) {
+                when (char) {
+                    '\\', '/', '^', '$', '.', '|', '?', '+', '(', ')', '[', ']', '{', '}' -> append('\\').append(char)
+                    '\n' -> append("\\n")
+                    '\r' -> append("\\r")
+                    '\u2028' -> append("\\u2028")
+                    '\u2029' -> append("\\u2029")
+                    else -> append(char)
+                }
+            }
+        }
+    }
+}
@@ -20,6 +20,29 @@ public interface JavaScriptBridge {
      */
     public suspend fun evaluateScript(script: String): String?
 
+    /**
+     * Evaluates [script] as a JavaScript function body and serializes the result in the page
+     * instead of converting it to a string. Use `return` to produce a value.
+     *
+     * The result is a JSON object whose `kind` is one of:
+     *
+     * | `kind` | Fields | Produced for |
+     * | --- | --- | --- |
+     * | `undefined` | none | `undefined` |
+     * | `null` | none | `null` |
+     * | `serializable` | `value`: the JSON value | arrays and plain objects that survive a JSON round trip unchanged |
+     * | `scriptObject` | `type`, `value`: strings | primitives (`typeof value`, `String(value)`) and all other objects and functions (`Object.prototype.toString`, `String(value)`) |
+     * | `error` | `stacktrace`: string | scripts that throw; the error's `stack` when it has one |
+     *
+     * Objects with accessors, cycles, non-finite numbers or a non-plain prototype are reported as
+     * `scriptObject`; no getter runs during serialization. When the jsbridge runtime is installed in
+     * the page its encoder is used, so `wvbridge.trustedJson` values are honoured.
+     *
+     * Returns `null` when the platform has no native serializer. Callers must then fall back to
+     * [evaluateScript]. Only the Linux WebKitGTK backend implements it.
+     */
+    public suspend fun evaluateScriptStructured(script: String): String? = null
+
     /**
      * Registers [script] so it runs at document start for future page loads.
      *
@@ -29,6 +52,15 @@ public interface JavaScriptBridge {
      */
     public suspend fun registerDocumentStartHook(script: String): CloseHandle
 
+    /**
+     * Registers [script] like [registerDocumentStartHook], but only runs it in the frames and
+     * documents allowed by [options].
+     *
+     * The default implementation wraps [script] in a guard described on [DocumentStartHookOptions].
+     */
+    public suspend fun registerDocumentStartHook(script: String, options: DocumentStartHookOptions): CloseHandle =
+        registerDocumentStartHook(options.guardScript(script))
+
     /**
      * Registers a native web-message handler for the current platform.
      *
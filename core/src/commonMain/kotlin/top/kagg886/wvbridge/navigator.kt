@@ -4,7 +4,7 @@ package top.kagg886.wvbridge
  * Common navigation controls for [WebViewController].
  *
  * This API covers the basic browser operations exposed by all supported backends: moving backward
- * and forward in history, refreshing, stopping the current load, and loading a new URL.
+ * and forward in history, refreshing, stopping the current load, and loading a new URL or HTML document.
  *
  * Both [Navigator.goBack] and [Navigator.goForward] return a flag describing whether
  * another step in the same direction is still available after the jump that was just requested.
@@ -59,4 +59,15 @@ public interface Navigator {
      *   supports it.
      */
     public fun loadUrl(url: String)
+
+    /**
+     * Starts a new top-level navigation that shows [html] directly, without encoding it into a
+     * `data:` URL or writing it to a file.
+     *
+     * @param html The document to show.
+     * @param baseUrl The URL relative links and resources in [html] are resolved against, and the
+     *   origin the page runs at. `null` loads it at `about:blank`. The Windows WebView2 backend
+     *   ignores it.
+     */
+    public fun loadHtml(html: String, baseUrl: String? = null)
 }
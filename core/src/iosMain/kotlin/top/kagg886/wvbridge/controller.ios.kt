@@ -19,8 +19,10 @@ import platform.darwin.NSObject
 import top.kagg886.wvbridge.config.WebViewConfig
 import top.kagg886.wvbridge.config.WebsiteDataStore
 import top.kagg886.wvbridge.util.CloseHandle
+import top.kagg886.wvbridge.bridge.DocumentStartHookOptions
 import top.kagg886.wvbridge.bridge.JavaScriptBridge
 import top.kagg886.wvbridge.bridge.WebMessageConsumer
+import top.kagg886.wvbridge.bridge.guardScript
 import top.kagg886.wvbridge.interceptor.Interceptor
 import top.kagg886.wvbridge.interceptor.InterceptorHandler
 import top.kagg886.wvbridge.util.LoggerReceiver
@@ -101,7 +103,7 @@ internal class WKNavigationInterceptor : Interceptor {
 
 internal class WKJavaScriptBridge(private val instance: WKWebView) : JavaScriptBridge {
     private var nextDocumentStartHookId = 0L
-    private val documentStartHooks = linkedMapOf<Long, String>()
+    private val documentStartHooks = linkedMapOf<Long, DocumentStartHook>()
     private val webMessageHandlers = linkedSetOf<WebMessageConsumer>()
     private val webMessageDispatcher = WKWebMessageDispatcher(webMessageHandlers)
 
@@ -134,12 +136,20 @@ internal class WKJavaScriptBridge(private val instance: WKWebView) : JavaScriptB
         }
     }
 
-    override suspend fun registerDocumentStartHook(script: String): CloseHandle {
-        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerDocumentStartHook: script=$script")
+    override suspend fun registerDocumentStartHook(script: String): CloseHandle =
+        registerDocumentStartHook(DocumentStartHook(script, mainFrameOnly = false))
+
+    override suspend fun registerDocumentStartHook(script: String, options: DocumentStartHookOptions): CloseHandle =
+        registerDocumentStartHook(
+            DocumentStartHook(options.guardScript(script, checkMainFrame = false), options.mainFrameOnly)
+        )
+
+    private fun registerDocumentStartHook(hook: DocumentStartHook): CloseHandle {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerDocumentStartHook: script=${hook.source}")
         val id = nextDocumentStartHookId++
         LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "registerDocumentStartHook: assigned id=$id")
-        documentStartHooks[id] = script
-        addDocumentStartUserScript(script)
+        documentStartHooks[id] = hook
+        addDocumentStartUserScript(hook)
 
         return object : CloseHandle {
             private var closed = false
@@ -217,12 +227,12 @@ internal class WKJavaScriptBridge(private val instance: WKWebView) : JavaScriptB
         documentStartHooks.values.forEach(::addDocumentStartUserScript)
     }
 
-    private fun addDocumentStartUserScript(script: String) {
-        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "addDocumentStartUserScript: script=$script")
+    private fun addDocumentStartUserScript(hook: DocumentStartHook) {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "addDocumentStartUserScript: script=${hook.source}")
         val userScript = WKUserScript(
-            source = script,
+            source = hook.source,
             injectionTime = WKUserScriptInjectionTime.WKUserScriptInjectionTimeAtDocumentStart,
-            forMainFrameOnly = false,
+            forMainFrameOnly = hook.mainFrameOnly,
         )
         LoggerReceiver.log(
             LoggerReceiver.Level.VERBOSE,
@@ -237,6 +247,8 @@ internal class WKJavaScriptBridge(private val instance: WKWebView) : JavaScriptB
         return RuntimeException("WKWebView JavaScript evaluation failed: $localizedDescription")
     }
 
+    private class DocumentStartHook(val source: String, val mainFrameOnly: Boolean)
+
     private companion object {
         private const val TAG = "WKJSBridge"
     }
@@ -298,6 +310,11 @@ internal class WKNavigator(private val instance: WKWebView) : Navigator {
         instance.loadRequest(NSURLRequest.requestWithURL(NSURL.URLWithString(url)!!))
     }
 
+    override fun loadHtml(html: String, baseUrl: String?) {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "loadHtml: length=${html.length} baseUrl=$baseUrl")
+        instance.loadHTMLString(html, baseUrl?.let { NSURL.URLWithString(it) })
+    }
+
     private companion object {
         private const val TAG = "WKWebViewNav"
     }
@@ -0,0 +1,14 @@
+package top.kagg886.wvbridge.bridge
+
+import java.nio.ByteBuffer
+
+/**
+ * Receives binary messages posted by the page to `wvbridge-data://message/<channel>`.
+ *
+ * [data] is a direct [ByteBuffer] over the native request body, so no Base64 or string conversion
+ * takes place. It is only valid until [consume] returns: read it or copy it synchronously and never
+ * keep a reference to it.
+ */
+public fun interface BinaryMessageConsumer {
+    public fun consume(channel: String, data: ByteBuffer)
+}
@@ -0,0 +1,30 @@
+package top.kagg886.wvbridge.bridge
+
+import top.kagg886.wvbridge.SwingPanelJavaScriptBridge
+import top.kagg886.wvbridge.internal.JvmTarget
+import top.kagg886.wvbridge.internal.jvmTarget
+import top.kagg886.wvbridge.util.CloseHandle
+
+/**
+ * Registers [handler] for binary messages the page sends on [channel].
+ *
+ * Pages post raw bytes with a plain `fetch`, so `ArrayBuffer`, typed arrays, and `Blob` bodies reach
+ * Kotlin without Base64 encoding:
+ *
+ * ```javascript
+ * await fetch("wvbridge-data://message/canvas", { method: "POST", body: await canvas.convertToBlob() });
+ * ```
+ *
+ * The request resolves with status 200 once a handler has consumed the body, or 404 when no handler
+ * is registered for the channel. [handler] runs on the native WebView thread.
+ *
+ * Only the Linux WebKitGTK backend (2.40 or newer) provides the `wvbridge-data` scheme.
+ *
+ * @throws UnsupportedOperationException on other desktop backends.
+ */
+public fun JavaScriptBridge.registerBinaryMessageHandler(channel: String, handler: BinaryMessageConsumer): CloseHandle {
+    if (this !is SwingPanelJavaScriptBridge || jvmTarget != JvmTarget.LINUX) {
+        throw UnsupportedOperationException("Binary messages are only supported by the Linux WebKitGTK backend")
+    }
+    return registerBinaryMessageHandler(channel, handler)
+}
@@ -1,7 +1,12 @@
 package top.kagg886.wvbridge.config
 
 import java.io.File
+import top.kagg886.wvbridge.config.internal.NativeLinuxCacheModel
+import top.kagg886.wvbridge.config.internal.NativeLinuxCrashRecoverySetting
+import top.kagg886.wvbridge.config.internal.NativeLinuxHardwareAcceleration
+import top.kagg886.wvbridge.config.internal.NativeLinuxMemoryPressureSetting
 import top.kagg886.wvbridge.config.internal.NativeLinuxWebViewPlatformSetting
+import top.kagg886.wvbridge.config.internal.NativeLinuxWebsiteDataStore
 import top.kagg886.wvbridge.config.internal.NativeMacOSWebViewPlatformSetting
 import top.kagg886.wvbridge.config.internal.NativeMacOSWebViewWebsiteDataStore
 import top.kagg886.wvbridge.config.internal.NativeWindowsWebViewPlatformSetting
@@ -41,11 +46,177 @@ public actual data class WebViewPlatformConfig(
      * use WebKitGTK's default location.
      * @property cacheDir Base website cache directory used by WebKitGTK, or `null`
      * to use WebKitGTK's default location.
+     * @property websiteDataStore Controls whether website data is written to
+     * [dataDir] and [cacheDir] or only kept in memory.
+     * @property performance WebKitGTK engine settings that trade features for
+     * memory and rendering cost.
+     * @property crashRecovery How the WebView recovers when its web process
+     * crashes or is killed for exceeding its memory limit, or `null` to close the
+     * WebView instead.
      */
     public data class Linux(
         val dataDir: String = System.getProperty("java.io.tmpdir") + File.separator + "wvbridge" + File.separator + "data",
-        val cacheDir: String = System.getProperty("java.io.tmpdir") + File.separator + "wvbridge" + File.separator + "cache"
-    )
+        val cacheDir: String = System.getProperty("java.io.tmpdir") + File.separator + "wvbridge" + File.separator + "cache",
+        val performance: Performance = Performance(),
+        val websiteDataStore: WebsiteDataStore = WebsiteDataStore.DEFAULT,
+        val crashRecovery: CrashRecovery? = null
+    ) {
+        /**
+         * Reloads the WebView in place after its web process dies, instead of
+         * closing it. The back-forward list is restored and the current entry is
+         * loaded again; document-start hooks and web message handlers stay
+         * registered. Listeners added with `addWebProcessRecoveryListener` are
+         * notified once the page has loaded again.
+         *
+         * The WebView is closed as before once it has crashed more than
+         * [maxAttempts] times within [periodSeconds], so a page that crashes on
+         * load does not reload forever.
+         *
+         * @property maxAttempts Recoveries allowed within [periodSeconds].
+         * @property periodSeconds Length of the window [maxAttempts] applies to.
+         */
+        public data class CrashRecovery(
+            val maxAttempts: Int = 3,
+            val periodSeconds: Int = 60
+        )
+
+        /**
+         * Website data storage mode used by the JVM Linux WebKitGTK backend.
+         */
+        public enum class WebsiteDataStore {
+            /**
+             * Store cookies, local storage, and the HTTP cache in [dataDir] and
+             * [cacheDir].
+             */
+            DEFAULT,
+
+            /**
+             * Keep website data in memory only. Every non-persistent WebView in the
+             * process shares one in-memory store, which is discarded once the last
+             * of them is closed.
+             */
+            NON_PERSISTENT
+        }
+
+        /**
+         * WebKitGTK performance settings. A `null` or `DEFAULT` value keeps
+         * WebKitGTK's own default.
+         *
+         * Use [DocumentViewer] for WebViews that mostly show static documents.
+         *
+         * @property cacheModel How much WebKit caches in memory. The cache model is
+         * shared by every WebView using the same web context.
+         * @property hardwareAcceleration When WebKit composites pages on the GPU.
+         * @property pageCache Keeps previous pages alive for instant back/forward
+         * navigation.
+         * @property smoothScrolling Animates scrolling.
+         * @property webGL Enables the WebGL API.
+         * @property media Enables audio and video playback.
+         * @property javaScriptCanOpenWindows Lets scripts open windows without a
+         * user gesture.
+         * @property dnsPrefetching Resolves host names of links before they are
+         * followed. Newer WebKitGTK versions ignore this setting.
+         * @property processSwapOnCrossSiteNavigation Loads each site in a new web
+         * process when navigating across sites. Setting it gives the WebView its
+         * own web context.
+         * @property memoryPressure Memory limits for the WebView's web processes.
+         * Setting it gives the WebView its own web context.
+         * @property suspendHiddenAfterMillis How long a hidden WebView stays throttled
+         * before it is suspended, or `null` to only throttle it. A hidden WebView is
+         * always reported to the page as hidden, so WebKit throttles its timers,
+         * animation frames, and rendering. Suspending goes further: the web process
+         * is terminated and its session state kept, and the page is reloaded at the
+         * same history entry when the WebView is shown again.
+         */
+        public data class Performance(
+            val cacheModel: CacheModel = CacheModel.DEFAULT,
+            val hardwareAcceleration: HardwareAcceleration = HardwareAcceleration.DEFAULT,
+            val pageCache: Boolean? = null,
+            val smoothScrolling: Boolean? = null,
+            val webGL: Boolean? = null,
+            val media: Boolean? = null,
+            val javaScriptCanOpenWindows: Boolean? = null,
+            val dnsPrefetching: Boolean? = null,
+            val processSwapOnCrossSiteNavigation: Boolean? = null,
+            val memoryPressure: MemoryPressure? = null,
+            val suspendHiddenAfterMillis: Long? = null
+        ) {
+            /**
+             * Memory limits for web processes, see `WebKitMemoryPressureSettings`
+             * (WebKitGTK 2.34 or newer). A `null` value keeps WebKitGTK's default.
+             *
+             * Thresholds are fractions of [memoryLimitMB]. Above the conservative and
+             * strict thresholds WebKit releases caches with increasing effort; above
+             * the kill threshold the web process is terminated and the WebView is
+             * closed, or reloaded when [Linux.crashRecovery] is set.
+             *
+             * @property memoryLimitMB Memory a web process may use, in megabytes.
+             * @property conservativeThreshold Fraction at which memory is released
+             * conservatively.
+             * @property strictThreshold Fraction at which memory is released
+             * aggressively.
+             * @property killThreshold Fraction at which the web process is killed.
+             * @property pollIntervalSeconds How often memory usage is checked.
+             */
+            public data class MemoryPressure(
+                val memoryLimitMB: Int,
+                val conservativeThreshold: Double? = null,
+                val strictThreshold: Double? = null,
+                val killThreshold: Double? = null,
+                val pollIntervalSeconds: Double? = null
+            )
+
+            /**
+             * WebKit memory cache model, see `WebKitCacheModel`.
+             */
+            public enum class CacheModel {
+                /** Keep WebKitGTK's default, [WEB_BROWSER]. */
+                DEFAULT,
+
+                /** Disable the memory cache; for single local documents. */
+                DOCUMENT_VIEWER,
+
+                /** A small cache, for browsing a few documents. */
+                DOCUMENT_BROWSER,
+
+                /** A large cache, for general web browsing. */
+                WEB_BROWSER
+            }
+
+            /**
+             * WebKit hardware acceleration policy, see `WebKitHardwareAccelerationPolicy`.
+             */
+            public enum class HardwareAcceleration {
+                /** Keep WebKitGTK's default. */
+                DEFAULT,
+
+                /** Composite on the GPU only while a page needs it. */
+                ON_DEMAND,
+
+                /** Always composite on the GPU. */
+                ALWAYS,
+
+                /** Never composite on the GPU. */
+                NEVER
+            }
+
+            public companion object {
+                /**
+                 * Settings for WebViews that show mostly static documents: no memory
+                 * cache, no compositing, and no page cache, WebGL, smooth scrolling,
+                 * or DNS prefetching.
+                 */
+                public val DocumentViewer: Performance = Performance(
+                    cacheModel = CacheModel.DOCUMENT_VIEWER,
+                    hardwareAcceleration = HardwareAcceleration.NEVER,
+                    pageCache = false,
+                    smoothScrolling = false,
+                    webGL = false,
+                    dnsPrefetching = false
+                )
+            }
+        }
+    }
 
     /**
      * macOS WKWebView-specific settings for JVM desktop.
@@ -85,11 +256,39 @@ internal fun WebViewConfig.currentJvmPlatformSetting(): Any = when (jvmTarget) {
         dataDir = platform.windowSetting.dataDir
     )
 
-    JvmTarget.LINUX -> NativeLinuxWebViewPlatformSetting(
-        userAgent = userAgent,
-        dataDir = platform.linuxSetting.dataDir,
-        cacheDir = platform.linuxSetting.cacheDir
-    )
+    JvmTarget.LINUX -> platform.linuxSetting.performance.let { performance ->
+        NativeLinuxWebViewPlatformSetting(
+            userAgent = userAgent,
+            dataDir = platform.linuxSetting.dataDir,
+            cacheDir = platform.linuxSetting.cacheDir,
+            websiteDataStore = NativeLinuxWebsiteDataStore.valueOf(platform.linuxSetting.websiteDataStore.name),
+            cacheModel = NativeLinuxCacheModel.valueOf(performance.cacheModel.name),
+            hardwareAcceleration = NativeLinuxHardwareAcceleration.valueOf(performance.hardwareAcceleration.name),
+            pageCache = performance.pageCache,
+            smoothScrolling = performance.smoothScrolling,
+            webGL = performance.webGL,
+            media = performance.media,
+            javaScriptCanOpenWindows = performance.javaScriptCanOpenWindows,
+            dnsPrefetching = performance.dnsPrefetching,
+            processSwapOnCrossSiteNavigation = performance.processSwapOnCrossSiteNavigation,
+            memoryPressure = performance.memoryPressure?.let { pressure ->
+                NativeLinuxMemoryPressureSetting(
+                    memoryLimitMB = pressure.memoryLimitMB,
+                    conservativeThreshold = pressure.conservativeThreshold ?: 0.0,
+                    strictThreshold = pressure.strictThreshold ?: 0.0,
+                    killThreshold = pressure.killThreshold ?: 0.0,
+                    pollIntervalSeconds = pressure.pollIntervalSeconds ?: 0.0
+                )
+            },
+            suspendHiddenAfterMillis = performance.suspendHiddenAfterMillis,
+            crashRecovery = platform.linuxSetting.crashRecovery?.let { recovery ->
+                NativeLinuxCrashRecoverySetting(
+                    maxAttempts = recovery.maxAttempts,
+                    periodSeconds = recovery.periodSeconds
+                )
+            }
+        )
+    }
 
     JvmTarget.MACOS -> NativeMacOSWebViewPlatformSetting(
         userAgent = userAgent,
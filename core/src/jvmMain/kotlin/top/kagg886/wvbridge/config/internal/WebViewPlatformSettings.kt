@@ -8,9 +8,56 @@ internal data class NativeWindowsWebViewPlatformSetting(
 internal data class NativeLinuxWebViewPlatformSetting(
     val userAgent: String?,
     val dataDir: String,
-    val cacheDir: String
+    val cacheDir: String,
+    val websiteDataStore: NativeLinuxWebsiteDataStore,
+    val cacheModel: NativeLinuxCacheModel,
+    val hardwareAcceleration: NativeLinuxHardwareAcceleration,
+    val pageCache: Boolean?,
+    val smoothScrolling: Boolean?,
+    val webGL: Boolean?,
+    val media: Boolean?,
+    val javaScriptCanOpenWindows: Boolean?,
+    val dnsPrefetching: Boolean?,
+    val processSwapOnCrossSiteNavigation: Boolean?,
+    val memoryPressure: NativeLinuxMemoryPressureSetting?,
+    // Applied by WebViewBridgePanel; native code does not read it.
+    val suspendHiddenAfterMillis: Long?,
+    val crashRecovery: NativeLinuxCrashRecoverySetting?
 )
 
+internal data class NativeLinuxCrashRecoverySetting(
+    val maxAttempts: Int,
+    val periodSeconds: Int
+)
+
+// Zero keeps WebKitGTK's default for a value.
+internal data class NativeLinuxMemoryPressureSetting(
+    val memoryLimitMB: Int,
+    val conservativeThreshold: Double,
+    val strictThreshold: Double,
+    val killThreshold: Double,
+    val pollIntervalSeconds: Double
+)
+
+internal enum class NativeLinuxWebsiteDataStore {
+    DEFAULT,
+    NON_PERSISTENT
+}
+
+internal enum class NativeLinuxCacheModel {
+    DEFAULT,
+    DOCUMENT_VIEWER,
+    DOCUMENT_BROWSER,
+    WEB_BROWSER
+}
+
+internal enum class NativeLinuxHardwareAcceleration {
+    DEFAULT,
+    ON_DEMAND,
+    ALWAYS,
+    NEVER
+}
+
 internal data class NativeMacOSWebViewPlatformSetting(
     val userAgent: String?,
     val websiteDataStore: NativeMacOSWebViewWebsiteDataStore
@@ -3,14 +3,19 @@ package top.kagg886.wvbridge
 import androidx.compose.runtime.*
 import kotlinx.coroutines.suspendCancellableCoroutine
 import top.kagg886.wvbridge.util.CloseHandle
+import top.kagg886.wvbridge.bridge.BinaryMessageConsumer
+import top.kagg886.wvbridge.bridge.DocumentStartHookOptions
 import top.kagg886.wvbridge.bridge.JavaScriptBridge
 import top.kagg886.wvbridge.bridge.WebMessageConsumer
 import top.kagg886.wvbridge.interceptor.Interceptor
 import top.kagg886.wvbridge.interceptor.InterceptorHandler
+import top.kagg886.wvbridge.internal.JvmTarget
 import top.kagg886.wvbridge.internal.WebViewBridgePanel
+import top.kagg886.wvbridge.internal.jvmTarget
 import top.kagg886.wvbridge.config.WebViewConfig
 import top.kagg886.wvbridge.config.currentJvmPlatformSetting
 import top.kagg886.wvbridge.util.LoggerReceiver
+import java.util.concurrent.CopyOnWriteArraySet
 import javax.swing.SwingUtilities
 import kotlin.coroutines.resume
 
@@ -98,12 +103,28 @@ internal class SwingPanelJavaScriptBridge(private val instance: WebViewBridgePan
         }
     }
 
-    override suspend fun registerDocumentStartHook(script: String): CloseHandle {
-        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerDocumentStartHook: script=$script")
+    override suspend fun evaluateScriptStructured(script: String): String? {
+        if (jvmTarget != JvmTarget.LINUX) return null
+
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "evaluateScriptStructured: script=$script")
+        return suspendCancellableCoroutine { c ->
+            SwingUtilities.invokeLater {
+                val result = instance.evaluateScriptStructured(script)
+                LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "evaluateScriptStructured: result=$result")
+                c.resume(result)
+            }
+        }
+    }
+
+    override suspend fun registerDocumentStartHook(script: String): CloseHandle =
+        registerDocumentStartHook(script, DocumentStartHookOptions.Default)
+
+    override suspend fun registerDocumentStartHook(script: String, options: DocumentStartHookOptions): CloseHandle {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerDocumentStartHook: script=$script options=$options")
         return suspendCancellableCoroutine {
             SwingUtilities.invokeLater {
                 LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "registerDocumentStartHook: on EDT")
-                val hookId = instance.registerDocumentStartHook(script)
+                val hookId = instance.registerDocumentStartHook(script, options)
                 LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "registerDocumentStartHook: hookId=$hookId")
                 it.resume(object : CloseHandle {
                     private var closed = false
@@ -160,6 +181,24 @@ internal class SwingPanelJavaScriptBridge(private val instance: WebViewBridgePan
         }
     }
 
+    internal fun registerBinaryMessageHandler(channel: String, handler: BinaryMessageConsumer): CloseHandle {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerBinaryMessageHandler: channel=$channel handler=$handler")
+        val handlers = instance.binaryMessageHandlers.computeIfAbsent(channel) { CopyOnWriteArraySet() }
+        check(handlers.add(handler)) {
+            "Binary message handler: [$handler] already registered for channel=$channel"
+        }
+
+        return object : CloseHandle {
+            override fun close() {
+                LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerBinaryMessageHandler.close: channel=$channel")
+                instance.binaryMessageHandlers.computeIfPresent(channel) { _, current ->
+                    current.remove(handler)
+                    current.takeUnless { it.isEmpty() }
+                }
+            }
+        }
+    }
+
     private companion object {
         private const val TAG = "SwingPanelJS"
     }
@@ -200,6 +239,11 @@ internal class SwingPanelNavigator(private val instance: WebViewBridgePanel) : N
         instance.loadUrl(url)
     }
 
+    override fun loadHtml(html: String, baseUrl: String?): Unit {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "loadHtml: length=${html.length} baseUrl=$baseUrl")
+        instance.loadHtml(html, baseUrl)
+    }
+
     private companion object {
         private const val TAG = "SwingPanelNav"
     }
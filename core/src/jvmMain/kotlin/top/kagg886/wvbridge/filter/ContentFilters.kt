@@ -0,0 +1,132 @@
+package top.kagg886.wvbridge.filter
+
+import top.kagg886.wvbridge.internal.JvmTarget
+import top.kagg886.wvbridge.internal.WebViewBridgePanel
+import top.kagg886.wvbridge.internal.jvmTarget
+import top.kagg886.wvbridge.internal.listener.NativeBridge
+import top.kagg886.wvbridge.util.CloseHandle
+import top.kagg886.wvbridge.util.LoggerReceiver
+import java.security.MessageDigest
+
+/**
+ * Content-blocking rule lists applied to every WebView in the process.
+ *
+ * Navigation interceptors only see top-level navigations. A content filter also blocks
+ * subresources such as trackers, ads, and third-party scripts before they are requested. Rules use
+ * the WebKit content blocker JSON format:
+ *
+ * ```kotlin
+ * val handle = ContentFilters.install("trackers", """
+ *     [{ "trigger": { "url-filter": ".*", "if-domain": ["*tracker.example"] }, "action": { "type": "block" } }]
+ * """)
+ * ```
+ *
+ * A rule list is compiled once and the compiled form is stored in a `content-filters` directory
+ * under the Linux `dataDir`, so later runs load it without compiling again. The list is only
+ * recompiled when its source changes. Filters apply to existing WebViews and to WebViews created
+ * later; compiling runs in the background, so a newly installed list may miss requests made before
+ * it is ready. A WebView whose `dataDir` is empty uses its WebKit context's data directory, and
+ * cannot use content filters when that context keeps no data on disk.
+ *
+ * Only the Linux WebKitGTK backend (2.26 or newer) supports content filters.
+ */
+public object ContentFilters {
+    private const val TAG = "ContentFilters"
+
+    private val IdentifierPattern = Regex("[A-Za-z0-9_-]+")
+
+    private class Filter(val rules: String, val hash: String, val onError: ContentFilterErrorListener?)
+
+    // Guards filters together with attaching them, so a WebView that starts while a list is being
+    // installed or removed ends up with the current set.
+    private val lock = Any()
+    private val filters = LinkedHashMap<String, Filter>()
+
+    /**
+     * Installs the rule list [rules] as [identifier] in every WebView, replacing an installed list
+     * with the same identifier. Closing the returned handle removes the list, unless it has been
+     * replaced since.
+     *
+     * [rules] are compiled in the background the first time a WebView needs them. When they do not
+     * compile, the list is uninstalled and [onError] is called with WebKit's reason; it is also
+     * called when a WebView has no directory to store the compiled list in.
+     *
+     * @throws IllegalArgumentException when [identifier] contains characters other than ASCII
+     * letters, digits, `-`, and `_`.
+     * @throws UnsupportedOperationException on other desktop backends.
+     */
+    public fun install(identifier: String, rules: String, onError: ContentFilterErrorListener? = null): CloseHandle {
+        if (jvmTarget != JvmTarget.LINUX) {
+            throw UnsupportedOperationException("Content filters are only supported by the Linux WebKitGTK backend")
+        }
+        require(IdentifierPattern.matches(identifier)) { "Invalid content filter identifier: $identifier" }
+
+        val filter = Filter(rules, hashOf(rules), onError)
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "install: identifier=$identifier hash=${filter.hash}")
+        synchronized(lock) {
+            filters[identifier] = filter
+            NativeBridge.registeredPanels.forEach { attach(it, identifier, filter) }
+        }
+
+        return object : CloseHandle {
+            override fun close() {
+                synchronized(lock) {
+                    if (filters[identifier] !== filter) return
+                    LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "uninstall: identifier=$identifier")
+                    filters.remove(identifier)
+                    NativeBridge.registeredPanels.forEach { panel ->
+                        runCatching { panel.detachContentFilter(identifier) }.onFailure {
+                            LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "uninstall: panel=$panel failed: $it")
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /** Attaches every installed list to [panel]; called once its native WebView exists. */
+    internal fun attachAll(panel: WebViewBridgePanel) {
+        if (jvmTarget != JvmTarget.LINUX) return
+        synchronized(lock) {
+            filters.forEach { (identifier, filter) -> attach(panel, identifier, filter) }
+        }
+    }
+
+    private fun attach(panel: WebViewBridgePanel, identifier: String, filter: Filter) {
+        runCatching { panel.attachContentFilter(identifier, filter.hash, filter.rules) }.onFailure {
+            LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "attach: identifier=$identifier panel=$panel failed: $it")
+            if (it is IllegalStateException) report(filter, identifier, it.message ?: it.toString())
+        }
+    }
+
+    /** Called by the native bridge when the list [identifier] with [hash] failed to compile. */
+    internal fun onCompileFailed(identifier: String, hash: String, reason: String) {
+        val filter = synchronized(lock) {
+            val filter = filters[identifier]?.takeIf { it.hash == hash } ?: return
+            filters.remove(identifier)
+            filter
+        }
+        report(filter, identifier, reason)
+    }
+
+    private fun report(filter: Filter, identifier: String, reason: String) {
+        val listener = filter.onError ?: return
+        runCatching { listener.onError(identifier, reason) }.onFailure {
+            LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "onError: identifier=$identifier listener threw: $it")
+        }
+    }
+
+    private fun hashOf(rules: String): String {
+        val digest = MessageDigest.getInstance("SHA-256").digest(rules.toByteArray(Charsets.UTF_8))
+        return digest.take(16).joinToString("") { "%02x".format(it) }
+    }
+}
+
+/**
+ * Receives failures of a list installed with [ContentFilters.install]. [onError] runs on the Swing
+ * event thread when the rules do not compile, or on the installing thread when a WebView cannot
+ * store compiled lists.
+ */
+public fun interface ContentFilterErrorListener {
+    public fun onError(identifier: String, reason: String)
+}
@@ -0,0 +1,52 @@
+package top.kagg886.wvbridge.internal
+
+import java.security.MessageDigest
+import java.util.Collections
+import java.util.WeakHashMap
+
+/**
+ * Keys for the native script intern table.
+ *
+ * Large scripts such as the jsbridge runtime are sent to the same and to different WebViews many
+ * times. Once a script has been interned, later calls pass only its key, so the source is not
+ * transcoded and copied across JNI again. The table lives in native code, is shared by every
+ * WebView in the process, and evicts least recently used scripts.
+ *
+ * Only the Linux backend implements the table.
+ */
+internal object ScriptIntern {
+    /** Scripts shorter than this are cheaper to send than to hash. */
+    private const val MIN_LENGTH = 4 * 1024
+
+    // Repeated scripts are usually the same String instance, which this map hits without hashing
+    // the content again. Entries go away with the script.
+    private val keys = Collections.synchronizedMap(WeakHashMap<String, String>())
+
+    val isSupported: Boolean
+        get() = jvmTarget == JvmTarget.LINUX
+
+    fun isEnabled(script: String): Boolean = isSupported && script.length >= MIN_LENGTH
+
+    /**
+     * Calls [call] with the key of [script] and no source first. When native code reports the key
+     * as unknown with [NoSuchElementException], calls it again with the source to intern.
+     */
+    inline fun <T> call(script: String, call: (key: String, source: String?) -> T): T {
+        val key = keyOf(script)
+        return try {
+            call(key, null)
+        } catch (e: NoSuchElementException) {
+            call(key, script)
+        }
+    }
+
+    fun keyOf(script: String): String = keys.getOrPut(script) {
+        val digest = MessageDigest.getInstance("SHA-256").digest(script.toByteArray(Charsets.UTF_8))
+        buildString(digest.size * 2 + 12) {
+            append(script.length).append('-')
+            digest.forEach { append(HEX[it.toInt() shr 4 and 0xF]).append(HEX[it.toInt() and 0xF]) }
+        }
+    }
+
+    private const val HEX = "0123456789abcdef"
+}
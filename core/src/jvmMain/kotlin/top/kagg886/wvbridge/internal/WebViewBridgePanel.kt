@@ -6,16 +6,27 @@ import java.awt.Graphics
 import java.awt.Point
 import java.awt.event.*
 import java.io.File
+import java.nio.ByteBuffer
 import java.nio.file.Files
+import java.util.concurrent.ConcurrentHashMap
 import java.util.concurrent.CopyOnWriteArraySet
 import java.util.concurrent.locks.ReentrantLock
 import java.util.function.BiConsumer
 import java.util.function.Consumer
 import javax.swing.SwingUtilities
+import javax.swing.Timer
 import kotlin.concurrent.withLock
 import top.kagg886.wvbridge.JvmNavigationInterceptor
+import top.kagg886.wvbridge.bridge.BinaryMessageConsumer
+import top.kagg886.wvbridge.bridge.DocumentStartHookOptions
 import top.kagg886.wvbridge.bridge.WebMessageConsumer
+import top.kagg886.wvbridge.bridge.guardScript
+import top.kagg886.wvbridge.config.internal.NativeLinuxWebViewPlatformSetting
+import top.kagg886.wvbridge.filter.ContentFilters
 import top.kagg886.wvbridge.internal.listener.NativeBridge
+import top.kagg886.wvbridge.recovery.WebProcessRecoveryListener
+import top.kagg886.wvbridge.scheme.SchemeHandler
+import top.kagg886.wvbridge.util.CloseHandle
 import top.kagg886.wvbridge.util.LoggerReceiver
 
 /**
@@ -57,6 +68,9 @@ internal class WebViewBridgePanel(
                 close(null, isInJvmExitProgress = true)
             })
         }
+        addHierarchyListener { event ->
+            if (event.changeFlags and HierarchyEvent.SHOWING_CHANGED.toLong() != 0L) onShowingChanged(isShowing)
+        }
         addComponentListener(object : ComponentAdapter() {
             override fun componentResized(e: ComponentEvent) {
                 if (handle == 0L) return
@@ -94,8 +108,33 @@ internal class WebViewBridgePanel(
 
     internal val closeListener = CopyOnWriteArraySet<Consumer<String?>>()
 
+    internal val webProcessRecoveryListener = CopyOnWriteArraySet<WebProcessRecoveryListener>()
+
     internal var navigationInterceptor: ((String) -> String)? = null
 
+    internal val binaryMessageHandlers = ConcurrentHashMap<String, CopyOnWriteArraySet<BinaryMessageConsumer>>()
+
+    internal val schemeHandlers = ConcurrentHashMap<String, SchemeHandler>()
+
+    // scheme -> absolute pack path, mounted natively once the view is attached.
+    private val assetPacks = ConcurrentHashMap<String, String>()
+    private val schemeLock = Any()
+
+    // Guards webProcessUnloaded against the panel being shown while it is unloaded.
+    private val memoryLock = Any()
+
+    /** [System.nanoTime] of the last time the panel was shown or hidden. */
+    @Volatile
+    internal var lastVisibleAt = System.nanoTime()
+        private set
+
+    @Volatile
+    internal var webProcessUnloaded = false
+        private set
+
+    // Suspends this panel once it has been hidden for suspendHiddenAfterMillis. EDT only.
+    private var suspendTimer: Timer? = null
+
     public fun addPageLoadingStartListener(handle: Consumer<String>): Unit =
         check(pageLoadingStartListener.add(handle)) {
             "Page loading start listener: [$handle] already added"
@@ -180,6 +219,11 @@ internal class WebViewBridgePanel(
             LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "addNotify: initAndAttach handle=$handle")
             NativeBridge.register(this)
             LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "addNotify: native bridge registered")
+            synchronized(schemeLock) {
+                schemeHandlers.keys.forEach { registerUriScheme(handle, it) }
+                assetPacks.forEach { (scheme, path) -> mountAssetPack(handle, scheme, path) }
+            }
+            ContentFilters.attachAll(this)
             initialize()
             LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "addNotify: initialize callback invoked")
             SwingUtilities.invokeLater {
@@ -200,6 +244,28 @@ internal class WebViewBridgePanel(
         loadUrl(handle, url)
     }
 
+    public fun loadHtml(html: String, baseUrl: String?): Unit {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "loadHtml: length=${html.length} baseUrl=$baseUrl")
+        loadHtml(handle, html, baseUrl)
+    }
+
+    /** Loads [length] bytes of the direct [buffer] from [offset] without copying them. */
+    internal fun loadBytes(
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int,
+        mimeType: String,
+        encoding: String?,
+        baseUrl: String?,
+    ) {
+        LoggerReceiver.log(
+            LoggerReceiver.Level.INFO,
+            TAG,
+            "loadBytes: length=$length mimeType=$mimeType encoding=$encoding baseUrl=$baseUrl"
+        )
+        loadBytes(handle, buffer, offset, length, mimeType, encoding, baseUrl)
+    }
+
     public fun refresh(): Unit {
         LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "refresh")
         refresh(handle)
@@ -226,18 +292,192 @@ internal class WebViewBridgePanel(
 
     public fun evaluateScript(script: String): String? {
         LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "evaluateScript: script=$script")
-        val result = evaluateScript(handle, script)
+        val result = if (ScriptIntern.isEnabled(script)) {
+            ScriptIntern.call(script) { key, source -> evaluateInternedScript(handle, key, source) }
+        } else {
+            evaluateScript(handle, script)
+        }
         LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "evaluateScript: result=$result")
         return result
     }
 
-    public fun registerDocumentStartHook(script: String): Long {
-        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerDocumentStartHook: script=$script")
-        val hookId = registerDocumentStartHook(handle, script)
+    public fun evaluateScriptStructured(script: String): String? {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "evaluateScriptStructured: script=$script")
+        val result = evaluateScriptStructured(handle, script)
+        LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "evaluateScriptStructured: result=$result")
+        return result
+    }
+
+    public fun registerDocumentStartHook(
+        script: String,
+        options: DocumentStartHookOptions = DocumentStartHookOptions.Default,
+    ): Long {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerDocumentStartHook: script=$script options=$options")
+        // Linux always goes through the intern table so identical hooks share one native script.
+        val hookId = if (ScriptIntern.isSupported) {
+            ScriptIntern.call(script) { key, source ->
+                registerInternedDocumentStartHook(
+                    handle,
+                    key,
+                    source,
+                    options.mainFrameOnly,
+                    options.allowedUrls.toTypedArray(),
+                    options.blockedUrls.toTypedArray(),
+                )
+            }
+        } else {
+            registerDocumentStartHook(handle, options.guardScript(script))
+        }
         LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "registerDocumentStartHook: hookId=$hookId")
         return hookId
     }
 
+    internal fun registerSchemeHandler(scheme: String, handler: SchemeHandler): CloseHandle {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerSchemeHandler: scheme=$scheme handler=$handler")
+        synchronized(schemeLock) {
+            check(schemeHandlers.putIfAbsent(scheme, handler) == null) {
+                "Scheme handler for [$scheme] is already registered"
+            }
+            // Before initAndAttach, addNotify registers the scheme natively.
+            if (handle != 0L) {
+                runCatching { registerUriScheme(handle, scheme) }.onFailure {
+                    schemeHandlers.remove(scheme, handler)
+                    throw it
+                }
+            }
+        }
+
+        // WebKit cannot unregister a scheme, so closing only detaches the handler and later
+        // requests are answered with 404.
+        return object : CloseHandle {
+            override fun close() {
+                LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerSchemeHandler.close: scheme=$scheme")
+                schemeHandlers.remove(scheme, handler)
+            }
+        }
+    }
+
+    internal fun registerAssetPack(scheme: String, path: String): CloseHandle {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerAssetPack: scheme=$scheme path=$path")
+        synchronized(schemeLock) {
+            check(assetPacks.putIfAbsent(scheme, path) == null) {
+                "Asset pack for [$scheme] is already registered"
+            }
+            if (handle != 0L) {
+                runCatching { mountAssetPack(handle, scheme, path) }.onFailure {
+                    assetPacks.remove(scheme, path)
+                    throw it
+                }
+            }
+        }
+
+        return object : CloseHandle {
+            override fun close() {
+                LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "registerAssetPack.close: scheme=$scheme")
+                synchronized(schemeLock) {
+                    if (assetPacks.remove(scheme, path) && handle != 0L) {
+                        mountAssetPack(handle, scheme, null)
+                    }
+                }
+            }
+        }
+    }
+
+    // Runs on the EDT.
+    private fun onShowingChanged(showing: Boolean) {
+        lastVisibleAt = System.nanoTime()
+        if (jvmTarget != JvmTarget.LINUX) return
+        val handle = handle
+        if (handle == 0L) return
+
+        LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "onShowingChanged: handle=$handle showing=$showing")
+        setVisible(handle, showing)
+        if (!showing) {
+            scheduleSuspend()
+            return
+        }
+
+        suspendTimer?.stop()
+        suspendTimer = null
+        synchronized(memoryLock) {
+            if (webProcessUnloaded) {
+                webProcessUnloaded = false
+                LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "restoreWebProcess: handle=$handle")
+                restoreWebProcess(handle)
+            }
+        }
+        update(handle, width, height, locationOnScreen.x, locationOnScreen.y)
+    }
+
+    private fun scheduleSuspend() {
+        val delay = (platformSetting as? NativeLinuxWebViewPlatformSetting)?.suspendHiddenAfterMillis ?: return
+        suspendTimer?.stop()
+        suspendTimer = Timer(delay.coerceIn(0L, Int.MAX_VALUE.toLong()).toInt()) {
+            suspendTimer = null
+            unloadWebProcess()
+        }.apply {
+            isRepeats = false
+            start()
+        }
+    }
+
+    /**
+     * Terminates the web process of this hidden panel to free its memory. The page is reloaded from
+     * its saved session state when the panel is shown again. Returns `false` when the panel is
+     * showing, closed, or already unloaded.
+     */
+    internal fun unloadWebProcess(): Boolean {
+        synchronized(memoryLock) {
+            if (webProcessUnloaded || isShowing || handle == 0L) return false
+            LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "unloadWebProcess: handle=$handle")
+            webProcessUnloaded = unloadWebProcess(handle)
+            return webProcessUnloaded
+        }
+    }
+
+    internal fun saveSessionState(): ByteArray {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "saveSessionState: handle=$handle")
+        return saveSessionState(handle)
+    }
+
+    internal fun restoreSessionState(state: ByteArray) {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "restoreSessionState: handle=$handle size=${state.size}")
+        synchronized(memoryLock) {
+            restoreSessionState(handle, state)
+            // The restored page relaunches the web process, so there is nothing left to restore on show.
+            webProcessUnloaded = false
+        }
+    }
+
+    /**
+     * Loads [url] in a hidden WebView that replaces the visible one when it navigates to [url]. The
+     * navigation interceptor is consulted now rather than on activation; a rejected or redirected
+     * [url] is not prerendered.
+     */
+    internal fun prerender(url: String, maxCount: Int, ttlMillis: Long): CloseHandle {
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "prerender: url=$url maxCount=$maxCount ttl=$ttlMillis")
+        val decision = navigationInterceptor?.invoke(url) ?: "1"
+        val id = if (decision.startsWith("1") && handle != 0L) prerender(handle, url, maxCount, ttlMillis) else 0L
+        LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "prerender: decision=$decision id=$id")
+
+        return object : CloseHandle {
+            override fun close() {
+                LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "prerender.close: url=$url id=$id")
+                if (id != 0L && handle != 0L) cancelPrerender(handle, id)
+            }
+        }
+    }
+
+    internal fun attachContentFilter(identifier: String, hash: String, rules: String) {
+        LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "attachContentFilter: identifier=$identifier hash=$hash")
+        if (handle != 0L) attachContentFilter(handle, identifier, hash, rules)
+    }
+
+    internal fun detachContentFilter(identifier: String) {
+        LoggerReceiver.log(LoggerReceiver.Level.VERBOSE, TAG, "detachContentFilter: identifier=$identifier")
+        if (handle != 0L) detachContentFilter(handle, identifier)
+    }
+
     public fun unregisterDocumentStartHook(hookId: Long): Unit {
         LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "unregisterDocumentStartHook: hookId=$hookId")
         unregisterDocumentStartHook(handle, hookId)
@@ -295,15 +535,46 @@ internal class WebViewBridgePanel(
 
     // ------------navigate function------------
     private external fun loadUrl(webview: Long, url: String)
+    private external fun loadHtml(webview: Long, html: String, baseUrl: String?)
+    private external fun loadBytes(
+        webview: Long,
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int,
+        mimeType: String,
+        encoding: String?,
+        baseUrl: String?,
+    )
     private external fun refresh(webview: Long)
     private external fun goBack(webview: Long): Boolean
     private external fun goForward(webview: Long): Boolean
     private external fun stop(webview: Long)
     private external fun evaluateScript(webview: Long, script: String): String?
+    private external fun evaluateScriptStructured(webview: Long, script: String): String?
     private external fun registerDocumentStartHook(webview: Long, script: String): Long
+    private external fun evaluateInternedScript(webview: Long, key: String, script: String?): String?
+    private external fun registerInternedDocumentStartHook(
+        webview: Long,
+        key: String,
+        script: String?,
+        mainFrameOnly: Boolean,
+        allowList: Array<String>,
+        blockList: Array<String>,
+    ): Long
     private external fun unregisterDocumentStartHook(webview: Long, hookId: Long)
     private external fun registerWebMessageHandler(webview: Long, callback: WebMessageConsumer): Long
     private external fun unregisterWebMessageHandler(webview: Long, handlerId: Long)
+    private external fun registerUriScheme(webview: Long, scheme: String)
+    private external fun mountAssetPack(webview: Long, scheme: String, path: String?)
+    private external fun attachContentFilter(webview: Long, identifier: String, hash: String, rules: String)
+    private external fun detachContentFilter(webview: Long, identifier: String)
+    private external fun setVisible(webview: Long, visible: Boolean)
+    private external fun unloadWebProcess(webview: Long): Boolean
+    private external fun restoreWebProcess(webview: Long): Boolean
+    private external fun saveSessionState(webview: Long): ByteArray
+    private external fun restoreSessionState(webview: Long, state: ByteArray)
+    private external fun prerender(webview: Long, url: String, maxCount: Int, ttlMillis: Long): Long
+    private external fun cancelPrerender(webview: Long, id: Long)
 
 
     @Suppress("UnsafeDynamicallyLoadedCode")
@@ -1,7 +1,11 @@
 package top.kagg886.wvbridge.internal.listener
 
+import top.kagg886.wvbridge.filter.ContentFilters
 import top.kagg886.wvbridge.internal.WebViewBridgePanel
+import top.kagg886.wvbridge.recovery.WebProcessRecovery
+import top.kagg886.wvbridge.scheme.SchemeRequest
 import top.kagg886.wvbridge.util.LoggerReceiver
+import java.nio.ByteBuffer
 import java.util.concurrent.ConcurrentHashMap
 import javax.swing.SwingUtilities
 
@@ -17,6 +21,10 @@ internal object NativeBridge {
         panels.remove(panel)
     }
 
+    /** Panels that currently have a native WebView. */
+    val registeredPanels: Collection<WebViewBridgePanel>
+        get() = panels
+
     private fun findPanel(webview: Long): WebViewBridgePanel? =
         panels.firstOrNull { it.handle == webview }
 
@@ -69,6 +77,64 @@ internal object NativeBridge {
         }
     }
 
+    @JvmStatic
+    private fun onWebProcessRecoveredCallback(webview: Long, cause: String, attempt: Int, durationMillis: Long, success: Boolean) {
+        LoggerReceiver.log(
+            LoggerReceiver.Level.INFO,
+            TAG,
+            "onWebProcessRecoveredCallback: webview=$webview cause=$cause attempt=$attempt duration=${durationMillis}ms success=$success"
+        )
+        val listeners = findPanel(webview)?.webProcessRecoveryListener
+        if (listeners.isNullOrEmpty()) return
+
+        val recovery = WebProcessRecovery(cause, attempt, durationMillis, success)
+        listeners.forEach { listener ->
+            runCatching {
+                listener.onRecovered(recovery)
+            }.onFailure {
+                LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "onWebProcessRecoveredCallback: listener threw: $it")
+            }
+        }
+    }
+
+    @JvmStatic
+    private fun onContentFilterFailedCallback(identifier: String, hash: String, reason: String?) {
+        LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "onContentFilterFailedCallback: identifier=$identifier reason=$reason")
+        // install() holds the filter lock while it waits for the GTK thread, so never take it here.
+        SwingUtilities.invokeLater { ContentFilters.onCompileFailed(identifier, hash, reason ?: "unknown") }
+    }
+
+    /**
+     * [data] aliases native memory that is released when this call returns.
+     */
+    @JvmStatic
+    private fun onBinaryMessageCallback(webview: Long, channel: String, data: ByteBuffer): Boolean {
+        val handlers = findPanel(webview)?.binaryMessageHandlers?.get(channel)
+        if (handlers.isNullOrEmpty()) return false
+
+        handlers.forEach { handler ->
+            runCatching {
+                handler.consume(channel, data.duplicate())
+            }.onFailure {
+                LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "onBinaryMessageCallback: handler threw: $it")
+            }
+        }
+        return true
+    }
+
+    /**
+     * Called on the native WebView thread for every request to a registered custom scheme.
+     */
+    @JvmStatic
+    private fun onSchemeRequestCallback(webview: Long, scheme: String, url: String, method: String): NativeSchemeResponse? {
+        val handler = findPanel(webview)?.schemeHandlers?.get(scheme) ?: return null
+        return runCatching {
+            handler.handle(SchemeRequest(url, method))?.let(NativeSchemeResponse::of)
+        }.onFailure {
+            LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "onSchemeRequestCallback: handler threw for url=$url: $it")
+        }.getOrNull()
+    }
+
     @JvmStatic
     private fun onNativeLoggerPostedCallback(level: String, tag: String, message: String): Unit = LoggerReceiver.log(
         LoggerReceiver.Level.valueOf(level), tag, message
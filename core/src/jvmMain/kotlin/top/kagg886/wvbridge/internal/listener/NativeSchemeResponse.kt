@@ -0,0 +1,40 @@
+package top.kagg886.wvbridge.internal.listener
+
+import top.kagg886.wvbridge.scheme.SchemeResponse
+import java.io.InputStream
+import java.nio.ByteBuffer
+
+/**
+ * [SchemeResponse] flattened for native code, which reads these fields directly. Exactly one of
+ * [buffer], [path], and [stream] is set, and [buffer] is always direct.
+ */
+internal class NativeSchemeResponse private constructor(
+    @JvmField val status: Int,
+    @JvmField val mimeType: String,
+    @JvmField val buffer: ByteBuffer?,
+    @JvmField val path: String?,
+    @JvmField val stream: InputStream?,
+    @JvmField val length: Long,
+) {
+    companion object {
+        fun of(response: SchemeResponse): NativeSchemeResponse = when (response) {
+            is SchemeResponse.Bytes -> {
+                val source = response.buffer.slice()
+                val buffer = if (source.isDirect) {
+                    source
+                } else {
+                    ByteBuffer.allocateDirect(source.remaining()).put(source).apply { flip() }
+                }
+                NativeSchemeResponse(response.statusCode, response.mimeType, buffer, null, null, -1)
+            }
+
+            is SchemeResponse.File -> NativeSchemeResponse(
+                response.statusCode, response.mimeType, null, response.path.toAbsolutePath().toString(), null, -1
+            )
+
+            is SchemeResponse.Stream -> NativeSchemeResponse(
+                response.statusCode, response.mimeType, null, null, response.stream, response.length
+            )
+        }
+    }
+}
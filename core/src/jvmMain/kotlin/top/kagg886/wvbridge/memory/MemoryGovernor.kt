@@ -0,0 +1,111 @@
+package top.kagg886.wvbridge.memory
+
+import top.kagg886.wvbridge.internal.JvmTarget
+import top.kagg886.wvbridge.internal.jvmTarget
+import top.kagg886.wvbridge.internal.listener.NativeBridge
+import top.kagg886.wvbridge.util.CloseHandle
+import top.kagg886.wvbridge.util.LoggerReceiver
+import java.io.File
+import java.util.concurrent.Executors
+import java.util.concurrent.ScheduledExecutorService
+import java.util.concurrent.ScheduledFuture
+import java.util.concurrent.TimeUnit
+
+/**
+ * Keeps the web processes of all WebViews in the process within a memory budget.
+ *
+ * While running, the governor periodically sums the resident memory of the process's WebKit web
+ * processes. When the total exceeds the budget, it unloads the hidden WebView that has been hidden
+ * the longest: its web process is terminated and its session state is kept, so the page is
+ * reloaded at the same history entry when the WebView is shown again. One WebView is unloaded per
+ * check, and WebViews that are showing are never unloaded.
+ *
+ * Per-web-process limits are configured separately with
+ * `WebViewPlatformConfig.Linux.Performance.memoryPressure`.
+ *
+ * Only the Linux WebKitGTK backend (2.34 or newer) supports the governor.
+ */
+public object MemoryGovernor {
+    private const val TAG = "MemoryGovernor"
+    private const val WEB_PROCESS_NAME = "WebKitWebProcess"
+
+    private val lock = Any()
+    private var executor: ScheduledExecutorService? = null
+    private var task: ScheduledFuture<*>? = null
+
+    /**
+     * Starts enforcing [budgetMB] megabytes across all web processes, checking every
+     * [checkIntervalMillis] milliseconds. Starting again replaces the previous budget. Closing the
+     * returned handle stops the governor unless it has been restarted since; unloaded WebViews are
+     * still restored when they are shown.
+     *
+     * @throws IllegalArgumentException when [budgetMB] or [checkIntervalMillis] is not positive.
+     * @throws UnsupportedOperationException on other desktop backends.
+     */
+    public fun start(budgetMB: Long, checkIntervalMillis: Long = 5_000): CloseHandle {
+        if (jvmTarget != JvmTarget.LINUX) {
+            throw UnsupportedOperationException("The memory governor is only supported by the Linux WebKitGTK backend")
+        }
+        require(budgetMB > 0) { "Memory budget must be positive: $budgetMB" }
+        require(checkIntervalMillis > 0) { "Check interval must be positive: $checkIntervalMillis" }
+
+        val budgetBytes = budgetMB * 1024 * 1024
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "start: budgetMB=$budgetMB interval=${checkIntervalMillis}ms")
+        val scheduled = synchronized(lock) {
+            task?.cancel(false)
+            val service = executor ?: Executors.newSingleThreadScheduledExecutor { runnable ->
+                Thread(runnable, "wvbridge-memory-governor").apply { isDaemon = true }
+            }.also { executor = it }
+            service.scheduleWithFixedDelay(
+                { runCatching { enforce(budgetBytes) }.onFailure { LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "check failed: $it") } },
+                checkIntervalMillis,
+                checkIntervalMillis,
+                TimeUnit.MILLISECONDS
+            ).also { task = it }
+        }
+
+        return object : CloseHandle {
+            override fun close() {
+                synchronized(lock) {
+                    if (task !== scheduled) return
+                    LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "stop")
+                    scheduled.cancel(false)
+                    task = null
+                }
+            }
+        }
+    }
+
+    private fun enforce(budgetBytes: Long) {
+        val used = webProcessResidentBytes()
+        if (used <= budgetBytes) return
+
+        val victim = NativeBridge.registeredPanels
+            .filter { !it.webProcessUnloaded && !it.isShowing }
+            .minByOrNull { it.lastVisibleAt }
+        if (victim == null) {
+            LoggerReceiver.log(LoggerReceiver.Level.WARN, TAG, "over budget used=$used budget=$budgetBytes, nothing to unload")
+            return
+        }
+        LoggerReceiver.log(LoggerReceiver.Level.INFO, TAG, "over budget used=$used budget=$budgetBytes, unloading $victim")
+        victim.unloadWebProcess()
+    }
+
+    /** Sums VmRSS of the WebKit web processes started by this process. */
+    private fun webProcessResidentBytes(): Long = ProcessHandle.current().descendants()
+        .filter { process -> process.info().command().map { it.endsWith(WEB_PROCESS_NAME) }.orElse(false) }
+        .mapToLong { residentBytes(it.pid()) }
+        .sum()
+
+    private fun residentBytes(pid: Long): Long = runCatching {
+        File("/proc/$pid/status").useLines { lines ->
+            lines.firstOrNull { it.startsWith("VmRSS:") }
+                ?.removePrefix("VmRSS:")
+                ?.trim()
+                ?.removeSuffix("kB")
+                ?.trim()
+                ?.toLong()
+                ?.times(1024)
+        }
+    }.getOrNull() ?: 0L
+}
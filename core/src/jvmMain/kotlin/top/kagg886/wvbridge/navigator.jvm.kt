@@ -0,0 +1,42 @@
+package top.kagg886.wvbridge
+
+import java.nio.ByteBuffer
+import top.kagg886.wvbridge.internal.JvmTarget
+import top.kagg886.wvbridge.internal.jvmTarget
+
+/**
+ * Starts a new top-level navigation that shows the remaining bytes of [data] as a document of type
+ * [mimeType], without encoding them into a `data:` URL or writing them to a file:
+ *
+ * ```kotlin
+ * val report = ByteBuffer.allocateDirect(size).apply { renderReport(this); flip() }
+ * controller.loadBytes(report, baseUrl = "app://reports/")
+ * ```
+ *
+ * A direct [data] is handed to WebKit in place, without copying, and kept alive until WebKit is
+ * done with it; do not modify it until the page has loaded. Other buffers are copied once. The
+ * position of [data] is left unchanged.
+ *
+ * Only the Linux WebKitGTK backend supports loading bytes; use [Navigator.loadHtml] elsewhere.
+ *
+ * @param encoding The character set of text content, such as `"utf-8"`. `null` lets WebKit detect it.
+ * @param baseUrl The URL relative links and resources are resolved against, and the origin the
+ *   page runs at. `null` loads it at `about:blank`.
+ * @throws UnsupportedOperationException on other desktop backends.
+ */
+public fun WebViewController<*>.loadBytes(
+    data: ByteBuffer,
+    mimeType: String = "text/html",
+    encoding: String? = null,
+    baseUrl: String? = null,
+) {
+    if (this !is SwingPanelController || jvmTarget != JvmTarget.LINUX) {
+        throw UnsupportedOperationException("Loading bytes is only supported by the Linux WebKitGTK backend")
+    }
+    if (data.isDirect) {
+        instance.loadBytes(data, data.position(), data.remaining(), mimeType, encoding, baseUrl)
+        return
+    }
+    val copy = ByteBuffer.allocateDirect(data.remaining()).put(data.duplicate())
+    instance.loadBytes(copy, 0, copy.capacity(), mimeType, encoding, baseUrl)
+}
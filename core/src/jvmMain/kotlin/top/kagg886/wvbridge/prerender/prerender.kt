@@ -0,0 +1,48 @@
+package top.kagg886.wvbridge.prerender
+
+import top.kagg886.wvbridge.SwingPanelController
+import top.kagg886.wvbridge.WebViewController
+import top.kagg886.wvbridge.internal.JvmTarget
+import top.kagg886.wvbridge.internal.jvmTarget
+import top.kagg886.wvbridge.util.CloseHandle
+
+/**
+ * Starts loading [url] in a hidden WebView, so that a later navigation to it, by
+ * [top.kagg886.wvbridge.Navigator.loadUrl] or a link click in the top-level page, shows the finished page at once
+ * instead of loading it:
+ *
+ * ```kotlin
+ * // The user is hovering the "next chapter" link.
+ * val prerender = controller.prerender(nextChapterUrl)
+ * // Drop it once the prediction no longer holds.
+ * prerender.close()
+ * ```
+ *
+ * The prerendered page gets the document-start hooks and content filters of this WebView, but it
+ * is only connected to the bridge once shown; messages it posts while hidden are dropped. The
+ * navigation interceptor is applied when the prerender is requested; a rejected or redirected [url]
+ * is not prerendered. The page starts with a copy of this WebView's back-forward history, and is
+ * dropped if this WebView navigates before it is shown.
+ *
+ * At most [maxPrerenders] pages are kept, dropping the oldest first, and each is dropped
+ * [timeToLiveMillis] after it starts unless it has been shown. Closing the returned handle drops
+ * the prerender if it has not been shown yet. Prerendering a URL that is already being prerendered
+ * does nothing.
+ *
+ * Only the Linux WebKitGTK backend supports prerendering.
+ *
+ * @throws IllegalArgumentException when [timeToLiveMillis] or [maxPrerenders] is not positive.
+ * @throws UnsupportedOperationException on other desktop backends.
+ */
+public fun WebViewController<*>.prerender(
+    url: String,
+    timeToLiveMillis: Long = 30_000,
+    maxPrerenders: Int = 2,
+): CloseHandle {
+    if (this !is SwingPanelController || jvmTarget != JvmTarget.LINUX) {
+        throw UnsupportedOperationException("Prerendering is only supported by the Linux WebKitGTK backend")
+    }
+    require(timeToLiveMillis > 0) { "Time to live must be positive: $timeToLiveMillis" }
+    require(maxPrerenders > 0) { "Prerender limit must be positive: $maxPrerenders" }
+    return instance.prerender(url, maxPrerenders, timeToLiveMillis)
+}
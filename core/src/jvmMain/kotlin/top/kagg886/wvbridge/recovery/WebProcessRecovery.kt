@@ -0,0 +1,27 @@
+package top.kagg886.wvbridge.recovery
+
+/**
+ * Receives [WebProcessRecovery] events from [addWebProcessRecoveryListener]. [onRecovered] runs on
+ * the native WebView thread.
+ */
+public fun interface WebProcessRecoveryListener {
+    public fun onRecovered(recovery: WebProcessRecovery)
+}
+
+/**
+ * A WebView that was reloaded in place after its web process died.
+ *
+ * @property cause Why the web process died, such as `WEBKIT_WEB_PROCESS_CRASHED` or
+ * `WEBKIT_WEB_PROCESS_EXCEEDED_MEMORY_LIMIT`.
+ * @property attempt How many times the WebView has been recovered within the configured period,
+ * starting at 1.
+ * @property durationMillis Time from the web process dying until the restored page finished
+ * loading.
+ * @property success Whether the restored page loaded successfully.
+ */
+public data class WebProcessRecovery(
+    val cause: String,
+    val attempt: Int,
+    val durationMillis: Long,
+    val success: Boolean,
+)
@@ -0,0 +1,37 @@
+package top.kagg886.wvbridge.recovery
+
+import top.kagg886.wvbridge.SwingPanelController
+import top.kagg886.wvbridge.WebViewController
+import top.kagg886.wvbridge.internal.JvmTarget
+import top.kagg886.wvbridge.internal.jvmTarget
+import top.kagg886.wvbridge.util.CloseHandle
+
+/**
+ * Notifies [listener] each time this WebView recovers from a web process crash:
+ *
+ * ```kotlin
+ * controller.addWebProcessRecoveryListener { recovery ->
+ *     metrics.record("webview.recovery", recovery.durationMillis, recovery.cause)
+ * }
+ * ```
+ *
+ * Recovery is enabled with `WebViewPlatformConfig.Linux.crashRecovery`; without it, or once its
+ * attempts are used up, the WebView is closed instead and no event is sent.
+ *
+ * Only the Linux WebKitGTK backend supports crash recovery.
+ *
+ * @throws UnsupportedOperationException on other desktop backends.
+ */
+public fun WebViewController<*>.addWebProcessRecoveryListener(listener: WebProcessRecoveryListener): CloseHandle {
+    if (this !is SwingPanelController || jvmTarget != JvmTarget.LINUX) {
+        throw UnsupportedOperationException("Crash recovery is only supported by the Linux WebKitGTK backend")
+    }
+    val listeners = instance.webProcessRecoveryListener
+    check(listeners.add(listener)) { "Web process recovery listener: [$listener] already added" }
+
+    return object : CloseHandle {
+        override fun close() {
+            listeners.remove(listener)
+        }
+    }
+}
@@ -0,0 +1,178 @@
+package top.kagg886.wvbridge.scheme
+
+import java.io.ByteArrayOutputStream
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.file.Files
+import java.nio.file.Path
+import java.security.MessageDigest
+import java.util.zip.GZIPOutputStream
+import kotlin.io.path.Path
+import kotlin.io.path.extension
+import kotlin.io.path.invariantSeparatorsPathString
+import kotlin.io.path.isDirectory
+import kotlin.io.path.isRegularFile
+import kotlin.io.path.outputStream
+import kotlin.io.path.readBytes
+import kotlin.io.path.relativeTo
+import kotlin.system.exitProcess
+
+/**
+ * Builds the asset packs mounted by [registerAssetPack].
+ *
+ * Call [build] from a Gradle task or at startup, or run the packer from the command line with the
+ * core JVM artifact on the class path:
+ *
+ * ```
+ * java -cp <classpath> top.kagg886.wvbridge.scheme.AssetPacks [--compress] <source directory> <output file>
+ * ```
+ */
+public object AssetPacks {
+    /**
+     * Packs every file under [source] into one asset pack written to [output], and returns the
+     * number of packed files.
+     *
+     * Entries are indexed by their path relative to [source] with `/` separators. When [compress]
+     * is set, text-like entries are stored gzip-compressed if that saves at least an eighth of
+     * their size; they are decoded natively when served.
+     *
+     * @throws IllegalArgumentException when [source] is not a directory.
+     * @throws java.io.IOException when a file cannot be read or [output] cannot be written.
+     */
+    public fun build(source: Path, output: Path, compress: Boolean = false): Int {
+        require(source.isDirectory()) { "Asset pack source is not a directory: $source" }
+
+        // Sorted by UTF-8 bytes so native code can binary search the mapped file. The layout is
+        // documented in platform/platform-linux/native/src/utils/asset_pack.h.
+        val files = Files.walk(source).use { paths -> paths.filter { it.isRegularFile() }.toList() }
+        val entries = files
+            .map { file -> PackEntry.of(file.relativeTo(source).invariantSeparatorsPathString, file, compress) }
+            .sortedWith { a, b -> compareUnsigned(a.path, b.path) }
+
+        val strings = ByteArrayOutputStream()
+        val stringOffsets = entries.map { entry ->
+            listOf(entry.path, entry.mimeType, entry.etag).map { value ->
+                val offset = strings.size()
+                strings.write(value)
+                offset to value.size
+            }
+        }
+
+        val indexEnd = HeaderSize + entries.size * RecordSize
+        val dataStart = indexEnd + strings.size()
+        val header = ByteBuffer.allocate(indexEnd).order(ByteOrder.LITTLE_ENDIAN)
+        header.put(Magic).putInt(Version).putInt(entries.size).putInt(0)
+
+        var dataOffset = dataStart.toLong()
+        entries.forEachIndexed { index, entry ->
+            stringOffsets[index].forEach { (offset, length) ->
+                header.putInt(indexEnd + offset).putInt(length)
+            }
+            header.putLong(dataOffset).putLong(entry.data.size.toLong())
+            header.putInt(if (entry.gzip) FlagGzip else 0).putInt(0)
+            dataOffset += entry.data.size
+        }
+
+        output.toAbsolutePath().parent?.let { Files.createDirectories(it) }
+        output.outputStream().buffered().use { out ->
+            out.write(header.array())
+            strings.writeTo(out)
+            entries.forEach { out.write(it.data) }
+        }
+        return entries.size
+    }
+
+    /**
+     * Command-line entry point: `[--compress] <source directory> <output file>`.
+     */
+    @JvmStatic
+    public fun main(args: Array<String>) {
+        val compress = "--compress" in args
+        val paths = args.filter { it != "--compress" }
+        if (paths.size != 2) {
+            System.err.println("usage: AssetPacks [--compress] <source directory> <output file>")
+            exitProcess(2)
+        }
+
+        val output = Path(paths[1])
+        val count = build(Path(paths[0]), output, compress)
+        println("Packed $count assets into $output (${Files.size(output)} bytes)")
+    }
+
+    private class PackEntry(
+        val path: ByteArray,
+        val mimeType: ByteArray,
+        val etag: ByteArray,
+        val data: ByteArray,
+        val gzip: Boolean,
+    ) {
+        companion object {
+            fun of(path: String, file: Path, compress: Boolean): PackEntry {
+                val content = file.readBytes()
+                val mimeType = mimeTypeOf(file)
+                val digest = MessageDigest.getInstance("SHA-256").digest(content)
+                val etag = digest.take(16).joinToString("", prefix = "\"", postfix = "\"") { "%02x".format(it) }
+
+                val compressed = if (compress && mimeType.isCompressible()) gzip(content) else null
+                val useGzip = compressed != null && compressed.size <= content.size - content.size / 8
+                return PackEntry(
+                    path = path.toByteArray(),
+                    mimeType = mimeType.toByteArray(),
+                    etag = etag.toByteArray(),
+                    data = if (useGzip) compressed!! else content,
+                    gzip = useGzip,
+                )
+            }
+        }
+    }
+
+    private val Magic = "WVPK".toByteArray()
+    private const val Version = 1
+    private const val HeaderSize = 16
+    private const val RecordSize = 48
+    private const val FlagGzip = 1
+
+    private val MimeTypes = mapOf(
+        "html" to "text/html",
+        "htm" to "text/html",
+        "js" to "text/javascript",
+        "mjs" to "text/javascript",
+        "css" to "text/css",
+        "json" to "application/json",
+        "map" to "application/json",
+        "svg" to "image/svg+xml",
+        "xml" to "application/xml",
+        "txt" to "text/plain",
+        "wasm" to "application/wasm",
+        "png" to "image/png",
+        "jpg" to "image/jpeg",
+        "jpeg" to "image/jpeg",
+        "gif" to "image/gif",
+        "webp" to "image/webp",
+        "avif" to "image/avif",
+        "ico" to "image/x-icon",
+        "woff" to "font/woff",
+        "woff2" to "font/woff2",
+        "ttf" to "font/ttf",
+        "otf" to "font/otf",
+    )
+
+    private fun mimeTypeOf(file: Path): String =
+        MimeTypes[file.extension.lowercase()]
+            ?: Files.probeContentType(file)
+            ?: "application/octet-stream"
+
+    private fun String.isCompressible(): Boolean =
+        startsWith("text/") || this in setOf("application/json", "application/xml", "application/wasm", "image/svg+xml")
+
+    private fun gzip(content: ByteArray): ByteArray =
+        ByteArrayOutputStream().also { out -> GZIPOutputStream(out).use { it.write(content) } }.toByteArray()
+
+    private fun compareUnsigned(a: ByteArray, b: ByteArray): Int {
+        for (i in 0 until minOf(a.size, b.size)) {
+            val order = (a[i].toInt() and 0xFF) - (b[i].toInt() and 0xFF)
+            if (order != 0) return order
+        }
+        return a.size - b.size
+    }
+}
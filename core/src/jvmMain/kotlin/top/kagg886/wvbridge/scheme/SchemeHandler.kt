@@ -0,0 +1,73 @@
+package top.kagg886.wvbridge.scheme
+
+import java.io.InputStream
+import java.nio.ByteBuffer
+import java.nio.file.Files
+import java.nio.file.Path
+
+/**
+ * Answers requests for a custom URL scheme registered with [registerSchemeHandler].
+ *
+ * [handle] runs on the native WebView thread and blocks page loading while it runs, so it should
+ * only pick the response. The response body is read later: [SchemeResponse.Stream] bodies are read
+ * on a background thread, and [SchemeResponse.Bytes] and [SchemeResponse.File] bodies are served
+ * from memory without copying.
+ *
+ * Return `null` to answer with 404.
+ */
+public fun interface SchemeHandler {
+    public fun handle(request: SchemeRequest): SchemeResponse?
+}
+
+/**
+ * A request for a custom scheme URL.
+ *
+ * @property url The full request URL, such as `app://bundle/index.html`.
+ * @property method The HTTP method, such as `GET`.
+ */
+public data class SchemeRequest(
+    val url: String,
+    val method: String,
+)
+
+/**
+ * The response to a [SchemeRequest].
+ *
+ * @property mimeType The `Content-Type` of the body.
+ * @property statusCode The HTTP status code.
+ */
+public sealed class SchemeResponse {
+    public abstract val mimeType: String
+    public abstract val statusCode: Int
+
+    /**
+     * Serves the remaining bytes of [buffer]. A direct buffer is handed to the WebView without
+     * copying and must not be modified afterwards; a heap buffer is copied once.
+     */
+    public class Bytes(
+        public val buffer: ByteBuffer,
+        override val mimeType: String,
+        override val statusCode: Int = 200,
+    ) : SchemeResponse()
+
+    /**
+     * Serves [stream] until it ends, then closes it. [length] is the body size in bytes, or `-1`
+     * when it is unknown.
+     */
+    public class Stream(
+        public val stream: InputStream,
+        override val mimeType: String,
+        public val length: Long = -1,
+        override val statusCode: Int = 200,
+    ) : SchemeResponse()
+
+    /**
+     * Serves the file at [path], which is memory-mapped by native code instead of being read
+     * through the JVM. A missing file is answered with 404.
+     */
+    public class File(
+        public val path: Path,
+        override val mimeType: String = Files.probeContentType(path) ?: "application/octet-stream",
+        override val statusCode: Int = 200,
+    ) : SchemeResponse()
+}
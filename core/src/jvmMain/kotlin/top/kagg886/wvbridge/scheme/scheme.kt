@@ -0,0 +1,71 @@
+package top.kagg886.wvbridge.scheme
+
+import top.kagg886.wvbridge.SwingPanelController
+import top.kagg886.wvbridge.WebViewController
+import top.kagg886.wvbridge.internal.JvmTarget
+import top.kagg886.wvbridge.internal.WebViewBridgePanel
+import top.kagg886.wvbridge.internal.jvmTarget
+import top.kagg886.wvbridge.util.CloseHandle
+import java.nio.file.Path
+
+private val SchemeNamePattern = Regex("[a-z][a-z0-9+.-]*")
+
+private val ReservedSchemes = setOf(
+    "about", "blob", "data", "file", "ftp", "http", "https", "javascript", "ws", "wss", "wvbridge-data",
+)
+
+/**
+ * Serves `<scheme>://` URLs in this WebView from [handler], so bundled web content can be loaded
+ * without a loopback HTTP server:
+ *
+ * ```kotlin
+ * controller.registerSchemeHandler("app") { request ->
+ *     val path = URI(request.url).path.removePrefix("/")
+ *     SchemeResponse.File(bundleRoot.resolve(path))
+ * }
+ * controller.navigator.loadUrl("app://bundle/index.html")
+ * ```
+ *
+ * The scheme is treated as secure and CORS-enabled. Register it before the first navigation that
+ * uses it; a WebView has at most one handler per scheme.
+ *
+ * Only the Linux WebKitGTK backend (2.36 or newer) supports custom schemes.
+ *
+ * @throws IllegalArgumentException when [scheme] is not a valid scheme name or is reserved.
+ * @throws UnsupportedOperationException on other desktop backends.
+ */
+public fun WebViewController<*>.registerSchemeHandler(scheme: String, handler: SchemeHandler): CloseHandle =
+    requireSchemeSupport(scheme) { panel, name -> panel.registerSchemeHandler(name, handler) }
+
+/**
+ * Serves `<scheme>://` URLs in this WebView from the asset pack at [pack], built with
+ * [AssetPacks.build].
+ *
+ * The pack is memory-mapped once and shared by every WebView that serves it. Requests are answered
+ * natively from the mapping without calling into the JVM, with the pack's precomputed `ETag` and
+ * MIME type. The URL host is ignored, and paths ending in `/` serve their `index.html`. Paths that
+ * are not in the pack fall through to the [registerSchemeHandler] handler for the same scheme, or
+ * are answered with 404.
+ *
+ * Only the Linux WebKitGTK backend (2.36 or newer) supports asset packs.
+ *
+ * @throws java.io.IOException when [pack] cannot be read or is not a valid asset pack.
+ * @throws IllegalArgumentException when [scheme] is not a valid scheme name or is reserved.
+ * @throws UnsupportedOperationException on other desktop backends.
+ */
+public fun WebViewController<*>.registerAssetPack(scheme: String, pack: Path): CloseHandle =
+    requireSchemeSupport(scheme) { panel, name -> panel.registerAssetPack(name, pack.toAbsolutePath().toString()) }
+
+private inline fun WebViewController<*>.requireSchemeSupport(
+    scheme: String,
+    register: (WebViewBridgePanel, String) -> CloseHandle,
+): CloseHandle {
+    if (this !is SwingPanelController || jvmTarget != JvmTarget.LINUX) {
+        throw UnsupportedOperationException("Custom URI schemes are only supported by the Linux WebKitGTK backend")
+    }
+
+    val name = scheme.lowercase()
+    require(SchemeNamePattern.matches(name)) { "Invalid URI scheme: $scheme" }
+    require(name !in ReservedSchemes) { "URI scheme is reserved: $scheme" }
+    return register(instance, name)
+}
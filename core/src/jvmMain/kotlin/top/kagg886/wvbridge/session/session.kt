@@ -0,0 +1,46 @@
+package top.kagg886.wvbridge.session
+
+import top.kagg886.wvbridge.SwingPanelController
+import top.kagg886.wvbridge.WebViewController
+import top.kagg886.wvbridge.internal.JvmTarget
+import top.kagg886.wvbridge.internal.WebViewBridgePanel
+import top.kagg886.wvbridge.internal.jvmTarget
+
+/**
+ * Captures the back-forward list of this WebView, including each entry's scroll position and
+ * form state, as an opaque byte array that can be stored and later passed to
+ * [restoreSessionState]:
+ *
+ * ```kotlin
+ * Files.write(tabFile, controller.saveSessionState())
+ * // on the next start
+ * controller.restoreSessionState(Files.readAllBytes(tabFile))
+ * ```
+ *
+ * The bytes are only meant to be read back by the same WebKitGTK backend.
+ *
+ * Only the Linux WebKitGTK backend supports session state.
+ *
+ * @throws UnsupportedOperationException on other desktop backends.
+ */
+public fun WebViewController<*>.saveSessionState(): ByteArray = requireSessionSupport().saveSessionState()
+
+/**
+ * Replaces the history of this WebView with [state] from [saveSessionState] and loads its current
+ * entry, so the whole back-forward list is restored with a single navigation. Call it once the
+ * controller is [top.kagg886.wvbridge.LoadingState.Ready].
+ *
+ * Only the Linux WebKitGTK backend supports session state.
+ *
+ * @throws IllegalArgumentException when [state] is not a saved session state.
+ * @throws UnsupportedOperationException on other desktop backends.
+ */
+public fun WebViewController<*>.restoreSessionState(state: ByteArray): Unit =
+    requireSessionSupport().restoreSessionState(state)
+
+private fun WebViewController<*>.requireSessionSupport(): WebViewBridgePanel {
+    if (this !is SwingPanelController || jvmTarget != JvmTarget.LINUX) {
+        throw UnsupportedOperationException("Session state is only supported by the Linux WebKitGTK backend")
+    }
+    return instance
+}
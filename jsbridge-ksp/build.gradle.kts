@@ -0,0 +1,20 @@
+import com.vanniktech.maven.publish.JavadocJar
+import com.vanniktech.maven.publish.KotlinJvm
+
+plugins {
+    id("org.jetbrains.kotlin.jvm")
+    id("com.vanniktech.maven.publish")
+}
+
+group = "top.kagg886.wvbridge"
+version()
+
+kotlin {
+    jvmToolchain(17)
+}
+
+dependencies {
+    implementation(libs.ksp.api)
+}
+
+publishing(KotlinJvm(javadocJar = JavadocJar.Empty(), sourcesJar = true))
@@ -0,0 +1,304 @@
+package top.kagg886.wvbridge.ksp
+
+import com.google.devtools.ksp.isAbstract
+import com.google.devtools.ksp.isInternal
+import com.google.devtools.ksp.processing.CodeGenerator
+import com.google.devtools.ksp.processing.Dependencies
+import com.google.devtools.ksp.processing.KSPLogger
+import com.google.devtools.ksp.processing.Resolver
+import com.google.devtools.ksp.processing.SymbolProcessor
+import com.google.devtools.ksp.processing.SymbolProcessorEnvironment
+import com.google.devtools.ksp.processing.SymbolProcessorProvider
+import com.google.devtools.ksp.symbol.ClassKind
+import com.google.devtools.ksp.symbol.KSAnnotated
+import com.google.devtools.ksp.symbol.KSClassDeclaration
+import com.google.devtools.ksp.symbol.KSType
+import com.google.devtools.ksp.symbol.Variance
+import com.google.devtools.ksp.validate
+
+private const val JsBridgeApiAnnotation = "top.kagg886.wvbridge.js.api.JsBridgeApi"
+
+public class JsBridgeApiProcessorProvider : SymbolProcessorProvider {
+    override fun create(environment: SymbolProcessorEnvironment): SymbolProcessor =
+        JsBridgeApiProcessor(environment.codeGenerator, environment.logger)
+}
+
+/**
+ * Generates a Kotlin dispatcher, a JavaScript client, and TypeScript declarations for every
+ * interface annotated with `@JsBridgeApi`.
+ */
+internal class JsBridgeApiProcessor(
+    private val codeGenerator: CodeGenerator,
+    private val logger: KSPLogger,
+) : SymbolProcessor {
+    override fun process(resolver: Resolver): List<KSAnnotated> {
+        val symbols = resolver.getSymbolsWithAnnotation(JsBridgeApiAnnotation).toList()
+        val deferred = symbols.filterNot { it.validate() }
+
+        symbols.filter { it.validate() }.forEach { symbol ->
+            if (symbol !is KSClassDeclaration || symbol.classKind != ClassKind.INTERFACE) {
+                logger.error("@JsBridgeApi can only be applied to interfaces", symbol)
+                return@forEach
+            }
+
+            val api = symbol.toApi() ?: return@forEach
+            generate(symbol, api)
+        }
+
+        return deferred
+    }
+
+    private fun KSClassDeclaration.toApi(): Api? {
+        val annotation = annotations.first {
+            it.annotationType.resolve().declaration.qualifiedName?.asString() == JsBridgeApiAnnotation
+        }
+        val arguments = annotation.arguments.associate { it.name?.asString() to it.value }
+        val name = (arguments["name"] as? String)?.takeIf { it.isNotEmpty() } ?: simpleName.asString()
+        val timeout = arguments["timeoutMillis"] as? Long ?: 30_000L
+
+        val functions = getAllFunctions().filter { it.isAbstract }.toList()
+        val duplicates = functions.groupBy { it.simpleName.asString() }.filterValues { it.size > 1 }.keys
+        if (duplicates.isNotEmpty()) {
+            logger.error("@JsBridgeApi does not support overloaded methods: ${duplicates.joinToString()}", this)
+            return null
+        }
+
+        if (typeParameters.isNotEmpty() || functions.any { it.typeParameters.isNotEmpty() }) {
+            logger.error("@JsBridgeApi does not support type parameters", this)
+            return null
+        }
+
+        return Api(
+            name = name,
+            timeoutMillis = timeout,
+            methods = functions.map { function ->
+                Method(
+                    name = function.simpleName.asString(),
+                    parameters = function.parameters.map { parameter ->
+                        Parameter(parameter.name!!.asString(), parameter.type.resolve())
+                    },
+                    returnType = function.returnType!!.resolve(),
+                )
+            },
+        )
+    }
+
+    private fun generate(declaration: KSClassDeclaration, api: Api) {
+        val packageName = declaration.packageName.asString()
+        val interfaceName = declaration.simpleName.asString()
+        val objectName = "${interfaceName}JsBridge"
+        val visibility = if (declaration.isInternal()) "internal" else "public"
+        val dependencies = Dependencies(aggregating = false, declaration.containingFile!!)
+
+        val clientScript = api.clientScript()
+
+        codeGenerator.createNewFile(dependencies, packageName, objectName).bufferedWriter().use { out ->
+            out.appendLine("// Generated by wvbridge jsbridge-ksp. Do not edit.")
+            if (packageName.isNotEmpty()) {
+                out.appendLine("package $packageName")
+                out.appendLine()
+            }
+
+            out.appendLine("import kotlinx.serialization.json.JsonNull")
+            out.appendLine("import kotlinx.serialization.serializer")
+            out.appendLine("import top.kagg886.wvbridge.bridge.JavaScriptBridge")
+            out.appendLine("import top.kagg886.wvbridge.js.api.JsBridgeApiRuntime")
+            out.appendLine("import top.kagg886.wvbridge.util.CloseHandle")
+            out.appendLine()
+            out.appendLine("$visibility object $objectName {")
+            out.appendLine("    $visibility const val NAME: String = ${api.name.toKotlinStringLiteral()}")
+            out.appendLine()
+            out.appendLine("    $visibility const val CLIENT_SCRIPT: String = ${clientScript.toKotlinStringLiteral()}")
+            out.appendLine("}")
+            out.appendLine()
+            out.appendLine("/**")
+            out.appendLine(" * Installs `window.wvbridge.api.${api.name}` in the page and dispatches its calls to [implementation].")
+            out.appendLine(" */")
+            out.appendLine("$visibility suspend fun JavaScriptBridge.register$interfaceName(implementation: $interfaceName): CloseHandle =")
+            out.appendLine("    JsBridgeApiRuntime.register(this, $objectName.NAME, $objectName.CLIENT_SCRIPT) { method, args ->")
+            out.appendLine("        when (method) {")
+            api.methods.forEachIndexed { index, method ->
+                val arguments = method.parameters.mapIndexed { position, parameter ->
+                    "JsBridgeApiRuntime.json.decodeFromJsonElement(serializer<${parameter.type.render()}>(), " +
+                        "args.getOrElse($position) { JsonNull })"
+                }
+                val call = "implementation.${method.name.escapeKotlinIdentifier()}(${arguments.joinToString(", ")})"
+
+                out.appendLine("            $index -> {")
+                if (method.returnType.isUnit()) {
+                    out.appendLine("                $call")
+                    out.appendLine("                JsonNull")
+                } else {
+                    out.appendLine("                val result = $call")
+                    out.appendLine("                JsBridgeApiRuntime.json.encodeToJsonElement(serializer<${method.returnType.render()}>(), result)")
+                }
+                out.appendLine("            }")
+            }
+            out.appendLine("            else -> throw IllegalArgumentException(\"Unknown ${api.name} method index \$method\")")
+            out.appendLine("        }")
+            out.appendLine("    }")
+        }
+
+        codeGenerator.createNewFile(dependencies, packageName, interfaceName, "d.ts").bufferedWriter().use { out ->
+            out.append(api.typeScriptDeclarations(interfaceName))
+        }
+    }
+
+    private fun Api.clientScript(): String = buildString {
+        appendLine("(() => {")
+        appendLine("    const wvbridge = window.wvbridge = window.wvbridge || {};")
+        appendLine("    const api = wvbridge.api = wvbridge.api || {};")
+        appendLine("    const name = ${name.toJavaScriptStringLiteral()};")
+        appendLine("    const call = (method, args) => new Promise((resolve, reject) => {")
+        appendLine("        window.wvbridge.postMessageAndReceiveResult(name, {")
+        appendLine("            timeout: $timeoutMillis,")
+        appendLine("            args: [window.wvbridge.trustedJson({ m: method, a: args })],")
+        appendLine("            success: (result) => result && typeof result.e === \"string\"")
+        appendLine("                ? reject(new Error(result.e))")
+        appendLine("                : resolve(result ? result.r : undefined),")
+        appendLine("            error: reject")
+        appendLine("        });")
+        appendLine("    });")
+        appendLine("    api[name] = {")
+        // Kotlin parameter names may be JavaScript reserved words, so the stubs forward rest arguments.
+        methods.forEachIndexed { index, method ->
+            appendLine("        ${method.name.toJavaScriptStringLiteral()}: (...args) => call($index, args),")
+        }
+        appendLine("    };")
+        append("})()")
+    }
+
+    private fun Api.typeScriptDeclarations(interfaceName: String): String = buildString {
+        appendLine("// Generated by wvbridge jsbridge-ksp. Do not edit.")
+        appendLine("// Available in pages as window.wvbridge.api[${name.toJavaScriptStringLiteral()}].")
+        appendLine("export interface $interfaceName {")
+        methods.forEach { method ->
+            val parameters = method.parameters.joinToString(", ") { "${it.name.escapeTypeScriptParameter()}: ${it.type.toTypeScript()}" }
+            val result = if (method.returnType.isUnit()) "void" else method.returnType.toTypeScript()
+            appendLine("    ${method.name}($parameters): Promise<$result>;")
+        }
+        appendLine("}")
+    }
+
+    private class Api(
+        val name: String,
+        val timeoutMillis: Long,
+        val methods: List<Method>,
+    )
+
+    private class Method(
+        val name: String,
+        val parameters: List<Parameter>,
+        val returnType: KSType,
+    )
+
+    private class Parameter(val name: String, val type: KSType)
+}
+
+private fun KSType.isUnit(): Boolean = declaration.qualifiedName?.asString() == "kotlin.Unit" && !isMarkedNullable
+
+/**
+ * Renders this type as fully qualified Kotlin source, including type arguments and nullability.
+ */
+private fun KSType.render(): String = buildString {
+    append(declaration.qualifiedName?.asString() ?: declaration.simpleName.asString())
+    if (arguments.isNotEmpty()) {
+        append(arguments.joinToString(", ", prefix = "<", postfix = ">") { argument ->
+            val type = argument.type?.resolve()
+            when {
+                argument.variance == Variance.STAR || type == null -> "*"
+                argument.variance == Variance.COVARIANT -> "out ${type.render()}"
+                argument.variance == Variance.CONTRAVARIANT -> "in ${type.render()}"
+                else -> type.render()
+            }
+        })
+    }
+    if (isMarkedNullable) append('?')
+}
+
+private fun KSType.toTypeScript(): String {
+    val name = declaration.qualifiedName?.asString()
+    val argumentTypes = arguments.map { it.type?.resolve()?.toTypeScript() ?: "unknown" }
+    val type = when (name) {
+        "kotlin.String", "kotlin.Char" -> "string"
+        "kotlin.Boolean" -> "boolean"
+        "kotlin.Byte", "kotlin.Short", "kotlin.Int", "kotlin.Long",
+        "kotlin.Float", "kotlin.Double",
+        "kotlin.UByte", "kotlin.UShort", "kotlin.UInt", "kotlin.ULong" -> "number"
+
+        "kotlin.collections.List", "kotlin.collections.Set", "kotlin.collections.Collection",
+        "kotlin.collections.MutableList", "kotlin.collections.MutableSet", "kotlin.Array" ->
+            "${argumentTypes.firstOrNull() ?: "unknown"}[]"
+
+        "kotlin.collections.Map", "kotlin.collections.MutableMap" ->
+            "Record<string, ${argumentTypes.getOrNull(1) ?: "unknown"}>"
+
+        "kotlinx.serialization.json.JsonElement", "kotlinx.serialization.json.JsonObject" -> "any"
+        else -> "unknown"
+    }
+
+    return if (isMarkedNullable) "$type | null" else type
+}
+
+/**
+ * Words that cannot name a TypeScript parameter, including strict-mode reserved words.
+ */
+private val TypeScriptReservedWords = setOf(
+    "arguments", "break", "case", "catch", "class", "const", "continue", "debugger", "default", "delete",
+    "do", "else", "enum", "eval", "export", "extends", "false", "finally", "for", "function", "if",
+    "implements", "import", "in", "instanceof", "interface", "let", "new", "null", "package", "private",
+    "protected", "public", "return", "static", "super", "switch", "this", "throw", "true", "try",
+    "typeof", "var", "void", "while", "with", "yield",
+)
+
+private fun String.escapeTypeScriptParameter(): String {
+    val identifier = map { if (it.isLetterOrDigit() || it == '_' || it == '$') it else '_' }.joinToString("")
+    return when {
+        identifier in TypeScriptReservedWords || identifier.first().isDigit() -> "${identifier}_"
+        else -> identifier
+    }
+}
+
+/**
+ * Kotlin hard keywords, which can only name a declaration when quoted with backticks.
+ */
+private val KotlinHardKeywords = setOf(
+    "as", "break", "class", "continue", "do", "else", "false", "for", "fun", "if", "in", "interface",
+    "is", "null", "object", "package", "return", "super", "this", "throw", "true", "try", "typealias",
+    "typeof", "val", "var", "when", "while",
+)
+
+private fun String.escapeKotlinIdentifier(): String =
+    if (this !in KotlinHardKeywords && all { it.isLetterOrDigit() || it == '_' }) this else "`$this`"
+
+private fun String.toKotlinStringLiteral(): String = buildString {
+    append('"')
+    for (char in this@toKotlinStringLiteral) {
+        when (char) {
+            '\\' -> append("\\\\")
+            '"' -> append("\\\"")
+            '$' -> append("\\$")
+            '\n' -> append("\\n")
+            '\r' -> append("\\r")
+            '\t' -> append("\\t")
+            else -> append(char)
+        }
+    }
+    append('"')
+}
+
+private fun String.toJavaScriptStringLiteral(): String = buildString {
+    append('"')
+    for (char in this@toJavaScriptStringLiteral) {
+        when (char) {
+            '\\' -> append("\\\\")
+            '"' -> append("\\\"")
+            '\n' -> append("\\n")
+            '\r' -> append("\\r")
+            '\u2028' -> append("\\u2028")
+            '\u2029' -> append("\\u2029")
+            else -> append(char)
+        }
+    }
+    append('"')
+}
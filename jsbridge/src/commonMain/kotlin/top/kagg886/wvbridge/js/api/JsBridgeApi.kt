@@ -0,0 +1,29 @@
+package top.kagg886.wvbridge.js.api
+
+/**
+ * Marks an interface as a typed JavaScript-to-Kotlin RPC API.
+ *
+ * With the `top.kagg886.wvbridge:jsbridge-ksp` processor applied, every annotated interface
+ * `Foo` gets:
+ *
+ * - `JavaScriptBridge.registerFoo(implementation)`, which installs the page client and dispatches
+ *   calls to `implementation` through [registerWebMessageHandlerWithReply][top.kagg886.wvbridge.js.registerWebMessageHandlerWithReply];
+ * - `FooJsBridge.CLIENT_SCRIPT`, the JavaScript client exposed to pages as
+ *   `window.wvbridge.api.Foo`, where every method returns a `Promise`;
+ * - `Foo.d.ts`, TypeScript declarations for the client.
+ *
+ * Calls are encoded positionally: the page sends the method index and the argument array, and the
+ * generated dispatcher decodes each argument with its compile-time serializer. Parameter and
+ * return types must therefore be serializable with kotlinx.serialization. Overloaded methods are
+ * not supported.
+ *
+ * @property name name used for the message type and for `window.wvbridge.api.<name>`. Defaults
+ * to the interface simple name.
+ * @property timeoutMillis page-side timeout of each call.
+ */
+@Target(AnnotationTarget.CLASS)
+@Retention(AnnotationRetention.BINARY)
+public annotation class JsBridgeApi(
+    val name: String = "",
+    val timeoutMillis: Long = 30_000,
+)
@@ -0,0 +1,79 @@
+package top.kagg886.wvbridge.js.api
+
+import kotlinx.coroutines.CancellationException
+import kotlinx.serialization.json.Json
+import kotlinx.serialization.json.JsonArray
+import kotlinx.serialization.json.JsonElement
+import kotlinx.serialization.json.buildJsonObject
+import kotlinx.serialization.json.intOrNull
+import kotlinx.serialization.json.jsonPrimitive
+import kotlinx.serialization.json.put
+import top.kagg886.wvbridge.bridge.JavaScriptBridge
+import top.kagg886.wvbridge.js.protocol.JSValue
+import top.kagg886.wvbridge.js.registerWebMessageHandlerWithReply
+import top.kagg886.wvbridge.util.CloseHandle
+
+/**
+ * Runtime support for code generated from [JsBridgeApi] interfaces.
+ *
+ * This is public only so generated code in other modules can call it; application code should use
+ * the generated `register<Api>` functions instead.
+ */
+public object JsBridgeApiRuntime {
+    /**
+     * JSON configuration used by generated dispatchers to decode arguments and encode results.
+     */
+    public val json: Json = Json {
+        ignoreUnknownKeys = true
+        encodeDefaults = true
+    }
+
+    /**
+     * Installs [clientScript] as a document-start hook and in the current page, and dispatches
+     * calls for API [name] to [dispatch].
+     *
+     * The page sends `{ m: methodIndex, a: [args...] }`. The reply is `{ r: result }` on success or
+     * `{ e: message }` when [dispatch] throws; the generated client resolves or rejects its
+     * `Promise` accordingly.
+     *
+     * The returned [CloseHandle] removes both the message handler and the document-start hook.
+     */
+    public suspend fun register(
+        bridge: JavaScriptBridge,
+        name: String,
+        clientScript: String,
+        dispatch: suspend (method: Int, args: JsonArray) -> JsonElement,
+    ): CloseHandle {
+        val handler = bridge.registerWebMessageHandlerWithReply(name) { values, reply ->
+            val response = try {
+                val call = (values.firstOrNull() as? JSValue.Serializable)?.value
+                    ?: throw IllegalArgumentException("$name call is malformed")
+                val method = call["m"]?.jsonPrimitive?.intOrNull
+                    ?: throw IllegalArgumentException("$name call without a method index")
+                val args = call["a"] as? JsonArray ?: JsonArray(emptyList())
+
+                buildJsonObject {
+                    put("r", dispatch(method, args))
+                }
+            } catch (error: CancellationException) {
+                throw error
+            } catch (error: Throwable) {
+                buildJsonObject {
+                    put("e", error.message ?: error.toString())
+                }
+            }
+
+            reply(JSValue.Serializable(response))
+        }
+
+        val hook = bridge.registerDocumentStartHook(clientScript)
+        bridge.evaluateScript(clientScript)
+
+        return object : CloseHandle {
+            override fun close() {
+                handler.close()
+                hook.close()
+            }
+        }
+    }
+}
@@ -1,70 +1,187 @@
 package top.kagg886.wvbridge.js
 
-import kotlinx.coroutines.CompletableDeferred
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Job
 import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.cancel
-import kotlinx.coroutines.coroutineScope
 import kotlinx.coroutines.currentCoroutineContext
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withTimeout
+import kotlinx.serialization.KSerializer
 import top.kagg886.wvbridge.util.CloseHandle
 import top.kagg886.wvbridge.bridge.JavaScriptBridge
-import top.kagg886.wvbridge.js.internal.WebViewBridgeExtInstallScript
 import top.kagg886.wvbridge.js.internal.JavaScriptBridgeReplyTokenPrefix
-import top.kagg886.wvbridge.js.internal.JavaScriptBridgeResultTokenPrefix
-import top.kagg886.wvbridge.js.internal.base64Encode
-import top.kagg886.wvbridge.js.internal.iife
+import top.kagg886.wvbridge.js.internal.JavaScriptBridgeScriptMissing
+import top.kagg886.wvbridge.js.internal.JavaScriptBridgeStreamReceiver
+import top.kagg886.wvbridge.js.internal.JavaScriptBridgeValueHeader
+import top.kagg886.wvbridge.js.internal.runtimeScript
+import top.kagg886.wvbridge.js.internal.getOrThrow
+import top.kagg886.wvbridge.js.internal.session
+import top.kagg886.wvbridge.js.internal.toJavaScriptLiteral
+import top.kagg886.wvbridge.js.internal.toJavaScriptStringLiteral
+import top.kagg886.wvbridge.js.internal.toTypedJSPackets
+import top.kagg886.wvbridge.js.internal.toTypedJavaScriptBridgeValue
+import top.kagg886.wvbridge.js.internal.unwrapWebViewStringLiteral
+import top.kagg886.wvbridge.js.protocol.CompiledScript
 import top.kagg886.wvbridge.js.protocol.JSPacket
 import top.kagg886.wvbridge.js.protocol.JSValue
 import top.kagg886.wvbridge.js.protocol.JavaScriptBridgeMessageHandler
 import top.kagg886.wvbridge.js.protocol.JavaScriptBridgeMessageHandlerWithReply
+import top.kagg886.wvbridge.js.protocol.JavaScriptBridgeStreamHandler
+import top.kagg886.wvbridge.js.protocol.JavaScriptBridgeTypedMessageHandler
 import kotlin.time.Duration
-import kotlin.uuid.ExperimentalUuidApi
-import kotlin.uuid.Uuid
 
 /**
  * Evaluates [script] as a JavaScript function body and normalizes the result to [JSValue].
  *
- * The wrapper sends [script] to the WebView as UTF-8 Base64, decodes it in the page, and executes
- * it with `Function(script).apply(globalThis)`. Because [script] is compiled as a function body,
+ * The wrapper embeds [script] in the page as a string literal and executes it with
+ * `Function(script).apply(globalThis)`. Because [script] is compiled as a function body,
  * callers must use `return` to produce a value.
  */
 public suspend fun JavaScriptBridge.evaluateScriptValue(script: String): JSValue {
-    ensureJavaScriptBridgePostMessageInstalled()
+    return with(JSValue) {
+        evaluateScriptValueWire(script).toJavaScriptBridgeValue()
+    }
+}
+
+/**
+ * Evaluates [script] like [evaluateScriptValue] and decodes the result directly into [T].
+ *
+ * The result is decoded from the wire string with [serializer] without building an intermediate
+ * [JSValue] or JSON tree. JavaScript string, number, and boolean results decode into matching
+ * primitive serializers, and `null` / `undefined` decode to `null` when [T] is nullable.
+ *
+ * @throws IllegalStateException when the script throws.
+ * @throws IllegalArgumentException when the result cannot be represented as [T].
+ */
+public suspend fun <T> JavaScriptBridge.evaluateScriptValue(script: String, serializer: KSerializer<T>): T {
+    return evaluateScriptValueWire(script)
+        .toTypedJavaScriptBridgeValue(serializer)
+        .getOrThrow(serializer, "JavaScriptBridge.evaluateScriptValue")
+}
 
-    val script = iife(
+private suspend fun JavaScriptBridge.evaluateScriptValueWire(script: String): String? {
+    // Backends that serialize the result natively skip the page-side wrapper and the runtime.
+    val structured = evaluateScriptStructured(script)
+    if (structured != null) return "$JavaScriptBridgeValueHeader:$structured"
+
+    val script = runtimeScript(
         script = """
             const bridge = window.__wvbridge__;
 
             try {
-                const script = bridge.decodeBase64("${script.base64Encode()}");
-                return bridge.wrapWire(
-                    bridge.valueHeader,
-                    bridge.toJSValueObject(Function(script).apply(globalThis))
-                );
+                const script = ${script.toJavaScriptStringLiteral()};
+                return bridge.valueHeader + ":" + bridge.toJSValueJson(Function(script).apply(globalThis));
             } catch (error) {
-                return bridge.wrapWire(
-                    bridge.valueHeader,
-                    bridge.toErrorValueObject(error)
-                );
+                return bridge.valueHeader + ":" + JSON.stringify(bridge.toErrorValueObject(error));
             }
         """.trimIndent()
     )
 
+    return session.evaluate(this, script)
+}
+
+/**
+ * Compiles [source] once in the page and returns a handle that can be invoked repeatedly.
+ *
+ * [source] is compiled as a function body with a single `args` parameter, the array of values
+ * passed to [invoke], and runs with `this` bound to `globalThis`. Use `return` to produce a value.
+ *
+ * @throws IllegalArgumentException when [source] does not compile.
+ */
+public suspend fun JavaScriptBridge.compileScript(source: String): CompiledScript {
+    val script = CompiledScript(session, session.nextScriptId(), source)
+    val result = evaluateCompiledScript(
+        "return window.__wvbridge__.compileScript(${script.id}, ${source.toJavaScriptStringLiteral()});"
+    )
+
+    if (result is JSValue.Error) {
+        throw IllegalArgumentException("JavaScriptBridge.compileScript failed: ${result.stacktrace}")
+    }
+
+    return script
+}
+
+/**
+ * Invokes a script compiled with [compileScript] and normalizes the result to [JSValue].
+ *
+ * Only the script ID and [args] are sent to the page. If the page does not know the script, for
+ * example because it navigated since the script was compiled, it is compiled again and invoked in
+ * the same evaluation.
+ *
+ * Only [JSValue.Undefined], [JSValue.Null], and [JSValue.Serializable] can be used as [args].
+ *
+ * @throws IllegalArgumentException when [script] was compiled by another bridge.
+ * @throws IllegalStateException when [script] has been disposed.
+ */
+public suspend fun JavaScriptBridge.invoke(script: CompiledScript, vararg args: JSValue): JSValue {
+    requireOwnScript(script, "JavaScriptBridge.invoke")
+    check(!script.disposed) { "JavaScriptBridge.invoke failed: script ${script.id} has been disposed" }
+
+    val arguments = args.joinToString(", ", prefix = "[", postfix = "]") {
+        it.toJavaScriptExpression("JavaScriptBridge.invoke")
+    }
+
+    val result = evaluateCompiledScript("return window.__wvbridge__.invokeScript(${script.id}, $arguments);")
+    if (result != null) {
+        return result
+    }
+
+    return evaluateCompiledScript(
+        """
+            const bridge = window.__wvbridge__;
+            bridge.compileScript(${script.id}, ${script.source.toJavaScriptStringLiteral()});
+            return bridge.invokeScript(${script.id}, $arguments);
+        """.trimIndent()
+    ) ?: error("JavaScriptBridge.invoke failed: script ${script.id} could not be compiled")
+}
+
+/**
+ * Drops the compiled function of [script] from the current page.
+ *
+ * The handle cannot be invoked afterwards. Disposing a handle twice does nothing.
+ *
+ * @throws IllegalArgumentException when [script] was compiled by another bridge.
+ */
+public suspend fun JavaScriptBridge.dispose(script: CompiledScript) {
+    requireOwnScript(script, "JavaScriptBridge.dispose")
+    if (script.disposed) return
+
+    script.disposed = true
+    session.evaluate(this, runtimeScript("return window.__wvbridge__.disposeScript(${script.id});"))
+}
+
+/**
+ * Script IDs are only unique within one bridge, so a handle must never reach another bridge's page.
+ */
+private fun JavaScriptBridge.requireOwnScript(script: CompiledScript, caller: String) {
+    require(script.session === session) { "$caller failed: $script was compiled by another bridge" }
+}
+
+/**
+ * Evaluates [body] and decodes its value wire string, or returns `null` when the page reported
+ * that the compiled script is missing.
+ */
+private suspend fun JavaScriptBridge.evaluateCompiledScript(body: String): JSValue? {
+    val result = session.evaluate(this, runtimeScript(body))
+    if (result?.unwrapWebViewStringLiteral() == JavaScriptBridgeScriptMissing) {
+        return null
+    }
+
     return with(JSValue) {
-        evaluateScript(script).toJavaScriptBridgeValue()
+        result.toJavaScriptBridgeValue()
     }
 }
 
 /**
  * Registers a JavaScript bridge message handler for packets whose packet type matches [type].
  *
- * On first use this installs the bridge post-message bootstrap script into the document-start hook
- * list and evaluates it in the current page, then delegates to [JavaScriptBridge.registerWebMessageHandler]
- * to receive raw WebView messages. Incoming messages that cannot be decoded as [JSPacket] or whose
- * packet type differs from [type] are ignored.
+ * On first use for this bridge this registers the bridge post-message bootstrap script as a
+ * document-start hook and evaluates it in the current page, then delegates to
+ * [JavaScriptBridge.registerWebMessageHandler] to receive raw WebView messages. Incoming messages
+ * that cannot be decoded as [JSPacket] or whose packet type differs from [type] are ignored.
+ * Batches sent by `window.wvbridge.configureBatching` are unpacked and [handle] is called once per
+ * matching packet, in order.
  *
  * The returned [CloseHandle] unregisters the underlying raw WebView message handler.
  *
@@ -75,20 +192,55 @@ public suspend fun JavaScriptBridge.registerWebMessageHandler(
     type: String,
     handle: JavaScriptBridgeMessageHandler,
 ): CloseHandle {
-    ensureJavaScriptBridgePostMessageInstalled()
+    session.ensureInstalled(this)
 
     return registerWebMessageHandler { message ->
-        val packet = runCatching {
+        val packets = runCatching {
             with(JSPacket) {
-                message.toJSPacket()
+                message.toJSPackets()
             }
         }.getOrNull() ?: return@registerWebMessageHandler
 
-        if (packet.type != type) {
-            return@registerWebMessageHandler
+        for (packet in packets) {
+            if (packet.type != type) {
+                continue
+            }
+
+            handle.handle(*packet.messages.toTypedArray())
         }
+    }
+}
+
+/**
+ * Registers a JavaScript bridge message handler whose payload values are decoded into [T].
+ *
+ * This is the typed form of [registerWebMessageHandler]. Packets whose type matches [type] are
+ * decoded from the wire string directly with [serializer], without building [JSValue] objects.
+ * Packets with a value that cannot be represented as [T] are ignored.
+ *
+ * @param type application-level packet type to accept.
+ * @param serializer serializer used for every payload value.
+ * @param handle callback invoked with the decoded payload values.
+ */
+public suspend fun <T> JavaScriptBridge.registerWebMessageHandler(
+    type: String,
+    serializer: KSerializer<T>,
+    handle: JavaScriptBridgeTypedMessageHandler<T>,
+): CloseHandle {
+    session.ensureInstalled(this)
 
-        handle.handle(*packet.messages.toTypedArray())
+    return registerWebMessageHandler { message ->
+        val packets = runCatching {
+            message.toTypedJSPackets(type, serializer)
+        }.getOrNull() ?: return@registerWebMessageHandler
+
+        for (messages in packets) {
+            val values = runCatching {
+                messages.map { it.getOrThrow(serializer, "JavaScriptBridge.registerWebMessageHandler") }
+            }.getOrNull() ?: continue
+
+            handle.handle(values)
+        }
     }
 }
 
@@ -110,49 +262,47 @@ public suspend fun JavaScriptBridge.registerWebMessageHandlerWithReply(
     type: String,
     handle: JavaScriptBridgeMessageHandlerWithReply,
 ): CloseHandle {
-    ensureJavaScriptBridgePostMessageInstalled()
+    session.ensureInstalled(this)
     val scope = CoroutineScope(SupervisorJob() + currentCoroutineContext().minusKey(Job))
     val rawHandle = registerWebMessageHandler { message ->
-        val packet = runCatching {
+        val packets = runCatching {
             with(JSPacket) {
-                message.toJSPacket()
+                message.toJSPackets()
             }
         }.getOrNull() ?: return@registerWebMessageHandler
 
-        if (packet.type != type) {
-            return@registerWebMessageHandler
-        }
+        for (packet in packets) {
+            if (packet.type != type) {
+                continue
+            }
 
-        val replyToken = packet.messages.lastOrNull() as? JSValue.ScriptObject
-        if (replyToken?.type != "string" || !replyToken.value.startsWith(JavaScriptBridgeReplyTokenPrefix)) {
-            return@registerWebMessageHandler
-        }
+            val replyToken = packet.messages.lastOrNull() as? JSValue.ScriptObject
+            if (replyToken?.type != "string" || !replyToken.value.startsWith(JavaScriptBridgeReplyTokenPrefix)) {
+                continue
+            }
 
-        val replyId = replyToken.value.removePrefix(JavaScriptBridgeReplyTokenPrefix)
-        val values = packet.messages.dropLast(1)
-        val reply: suspend (JSValue) -> Unit = { value ->
-            runCatching {
-                val script = iife(
-                    script = """
-                            const replyId = window.__wvbridge__.decodeBase64("${replyId.base64Encode()}");
-                            const reply = window.__wvbridge__[replyId];
-                            if (typeof reply !== "function") {
-                                return false;
-                            }
-
-                            reply(${value.toJavaScriptExpression("JavaScriptBridge.registerWebMessageHandlerWithReply.reply")});
-                            return true;
-                        """.trimIndent()
-                )
-
-                evaluateScript(script)
-                    .requireJavaScriptBooleanResult("JavaScriptBridge.registerWebMessageHandlerWithReply.reply")
+            val replyId = replyToken.value.removePrefix(JavaScriptBridgeReplyTokenPrefix)
+            val values = packet.messages.dropLast(1)
+            val reply: suspend (JSValue) -> Unit = { value ->
+                runCatching {
+                    val body = """
+                        const reply = window.__wvbridge__[${replyId.toJavaScriptStringLiteral()}];
+                        if (typeof reply !== "function") {
+                            return false;
+                        }
+
+                        reply(${value.toJavaScriptExpression("JavaScriptBridge.registerWebMessageHandlerWithReply.reply")});
+                        return true;
+                    """.trimIndent()
+
+                    session.outbox.send(this, body, "JavaScriptBridge.registerWebMessageHandlerWithReply.reply")
+                }
             }
-        }
 
-        scope.launch {
-            runCatching {
-                handle.handle(values, reply)
+            scope.launch {
+                runCatching {
+                    handle.handle(values, reply)
+                }
             }
         }
     }
@@ -165,14 +315,50 @@ public suspend fun JavaScriptBridge.registerWebMessageHandlerWithReply(
     }
 }
 
+/**
+ * Registers a handler for byte streams opened with `window.wvbridge.openStream(type)`.
+ *
+ * Large payloads are split by the page into chunks of at most 64 KiB, so no single message has to
+ * hold the whole payload on either side. Every stream is delivered to [handle] as a
+ * `Flow<ByteArray>` in its own coroutine. The page can only run a bounded number of chunks ahead of
+ * the collector: its `write` promises wait until Kotlin has consumed earlier chunks.
+ *
+ * Streams opened for a type without a registered handler are never acknowledged and stall once
+ * their initial credit is used.
+ *
+ * @param type application-level stream type to accept.
+ * @param handle callback invoked once per stream.
+ */
+public suspend fun JavaScriptBridge.registerStreamHandler(
+    type: String,
+    handle: JavaScriptBridgeStreamHandler,
+): CloseHandle {
+    session.ensureInstalled(this)
+    val scope = CoroutineScope(SupervisorJob() + currentCoroutineContext().minusKey(Job))
+    val receiver = JavaScriptBridgeStreamReceiver(this, type, handle, scope)
+    val rawHandle = registerWebMessageHandler { message -> receiver.onMessage(message) }
+
+    return object : CloseHandle {
+        override fun close() {
+            rawHandle.close()
+            receiver.closeAll()
+            scope.cancel()
+        }
+    }
+}
+
 
 /**
  * Dispatches a typed message from native code to JavaScript listeners registered with
  * `window.wvbridge.addEventListener(type, listener)`.
  *
- * On first use this installs the bridge post-message bootstrap script into the document-start hook
- * list and evaluates it in the current page. [values] are then delivered to listeners as
- * `listener(...values)` by calling `window.wvbridge.dispatchEvent(type, ...values)`.
+ * The bridge bootstrap script is installed on demand when the current page does not have it yet.
+ * [values] are delivered to listeners as `listener(...values)` by calling
+ * `window.wvbridge.dispatchEvent(type, ...values)`.
+ *
+ * Messages are sent through a per-bridge outbound queue: messages posted while a previous batch is
+ * still being evaluated are dispatched together, in order, with one script evaluation. This
+ * function still suspends until its own message has been dispatched.
  *
  * Only [JSValue.Undefined], [JSValue.Null], and [JSValue.Serializable] can be sent because the
  * page-side value must be representable as `undefined`, `null`, or JSON.
@@ -181,10 +367,8 @@ public suspend fun JavaScriptBridge.registerWebMessageHandlerWithReply(
  * @param values payload values delivered to matching JavaScript listeners.
  */
 public suspend fun JavaScriptBridge.postMessage(type: String, vararg values: JSValue) {
-    ensureJavaScriptBridgePostMessageInstalled()
-
     val arguments = buildList {
-        add("window.__wvbridge__.decodeBase64('${type.base64Encode()}')")
+        add(type.toJavaScriptStringLiteral())
 
         addAll(
             elements = values.map { value ->
@@ -193,16 +377,11 @@ public suspend fun JavaScriptBridge.postMessage(type: String, vararg values: JSV
         )
     }
 
-    val script = iife(
-        script = """
-            return window.wvbridge.dispatchEvent(
-                ${arguments.joinToString(",\n")}
-            );
-        """.trimIndent()
+    val dispatched = session.outbox.send(
+        bridge = this,
+        body = "return window.wvbridge.dispatchEvent(${arguments.joinToString(", ")});",
+        apiName = "JavaScriptBridge.postMessage",
     )
-
-    val dispatched = evaluateScript(script)
-        .requireJavaScriptBooleanResult("JavaScriptBridge.postMessage")
     check(dispatched) {
         "JavaScriptBridge.postMessage failed: no JavaScript listener handled type '$type'"
     }
@@ -212,19 +391,20 @@ public suspend fun JavaScriptBridge.postMessage(type: String, vararg values: JSV
 /**
  * Dispatches a typed message to JavaScript and suspends until JavaScript returns one result.
  *
- * This is the request/response form of [postMessage]. The function installs a temporary native
- * response handler, dispatches [type] through `window.wvbridge.dispatchEvent`, and appends a
- * JavaScript callback after [args]. The page must register its listener with
- * `window.wvbridge.addEventListener(type, listener)` before native code calls this API; otherwise
- * the dispatch has no listener to invoke and the call will wait until [timeout]. The JavaScript
- * listener receives `...args, reply` and should call `reply(result)` once.
+ * This is the request/response form of [postMessage]. The function dispatches [type] through
+ * `window.wvbridge.dispatchEvent` and appends a JavaScript callback after [args]. The callback
+ * answers through a single response handler kept per bridge, matched by a correlation ID. The
+ * page must register its listener with `window.wvbridge.addEventListener(type, listener)` before
+ * native code calls this API; otherwise the dispatch has no listener to invoke and the call will
+ * wait until [timeout]. The JavaScript listener receives `...args, reply` and should call
+ * `reply(result)` once.
  *
  * The returned value is the callback argument normalized as [JSValue]. Only [JSValue.Undefined],
  * [JSValue.Null], and [JSValue.Serializable] can be used as outgoing [args] because they must be
  * representable as `undefined`, `null`, or a [kotlinx.serialization.json.JsonElement] in the page.
  *
- * The temporary response handler is always unregistered before this function returns or throws.
- * If JavaScript does not call the callback before [timeout], this function throws
+ * The pending call is always removed before this function returns or throws. If JavaScript does
+ * not call the callback before [timeout], this function throws
  * [kotlinx.coroutines.TimeoutCancellationException].
  *
  * @param type application-level packet type to dispatch.
@@ -232,76 +412,52 @@ public suspend fun JavaScriptBridge.postMessage(type: String, vararg values: JSV
  * @param args payload values delivered to the JavaScript listener before the response callback.
  * @return the value passed by JavaScript to the response callback.
  */
-@OptIn(ExperimentalUuidApi::class)
 public suspend fun JavaScriptBridge.postMessageAndReceiveResult(
     type: String,
     timeout: Duration,
     vararg args: JSValue,
-): JSValue = coroutineScope {
-    ensureJavaScriptBridgePostMessageInstalled()
-
-    val deferred = CompletableDeferred<JSValue>()
-    val responseToken = "$JavaScriptBridgeResultTokenPrefix${Uuid.random().toHexString()}"
-    val handle = registerWebMessageHandler(responseToken) { values ->
-        deferred.complete(values.firstOrNull() ?: JSValue.Undefined)
-    }
+): JSValue {
+    val rpc = session.rpc
+    session.ensureInstalled(this)
+    rpc.ensureRegistered(this)
 
+    val call = rpc.open()
     try {
-        val arguments = args.map {
-            it.toJavaScriptExpression("JavaScriptBridge.postMessageAndReceiveResult")
+        val arguments = buildList {
+            add(type.toJavaScriptStringLiteral())
+
+            addAll(
+                elements = args.map {
+                    it.toJavaScriptExpression("JavaScriptBridge.postMessageAndReceiveResult")
+                }
+            )
+
+            add("(result) => window.__wvbridge__.postResult(${call.id.toJavaScriptStringLiteral()}, result)")
         }
 
-        val script = iife(
-            script = """
-                const type = window.__wvbridge__.decodeBase64("${type.base64Encode()}");
-                const responseType = window.__wvbridge__.decodeBase64("${responseToken.base64Encode()}");
-                return window.wvbridge.dispatchEvent(
-                    type,
-                    ${arguments.joinToString(",\n")},
-                    (result) => window.wvbridge.postMessage(responseType, result)
-                );
-            """.trimIndent()
+        val dispatched = session.outbox.send(
+            bridge = this,
+            body = "return window.wvbridge.dispatchEvent(${arguments.joinToString(", ")});",
+            apiName = "JavaScriptBridge.postMessageAndReceiveResult",
         )
-
-        val dispatched = evaluateScript(script)
-            .requireJavaScriptBooleanResult("JavaScriptBridge.postMessageAndReceiveResult")
         check(dispatched) {
             "JavaScriptBridge.postMessageAndReceiveResult failed: no JavaScript listener handled type '$type'"
         }
 
-        withTimeout(timeout) {
-            deferred.await()
+        return withTimeout(timeout) {
+            call.result.await()
         }
     } finally {
-        handle.close()
+        call.close()
     }
 }
 
 private fun JSValue.toJavaScriptExpression(apiName: String): String = when (this) {
     JSValue.Undefined -> "undefined"
     JSValue.Null -> "null"
-    is JSValue.Serializable -> value.toString().base64Encode().let {
-        "JSON.parse(window.__wvbridge__.decodeBase64(\"$it\"))"
-    }
+    is JSValue.Serializable -> value.toJavaScriptLiteral()
 
     is JSValue.ScriptObject, is JSValue.Error -> throw IllegalArgumentException(
         "$apiName only supports JSValue.Undefined, JSValue.Null, and JSValue.Serializable"
     )
 }
-
-private fun String?.requireJavaScriptBooleanResult(apiName: String): Boolean = when (this) {
-    "true", "\"true\"" -> true
-    "false", "\"false\"" -> false
-    else -> error("$apiName expected JavaScript to return true or false, but got ${this ?: "null"}")
-}
-
-private suspend fun JavaScriptBridge.ensureJavaScriptBridgePostMessageInstalled() {
-    val installed = evaluateScript("window.__wvbridge__ !== undefined")
-        ?.let { it == "true" || it == "\"true\"" }
-        ?: false
-
-    if (!installed) {
-        registerDocumentStartHook(WebViewBridgeExtInstallScript)
-        evaluateScript(WebViewBridgeExtInstallScript)
-    }
-}
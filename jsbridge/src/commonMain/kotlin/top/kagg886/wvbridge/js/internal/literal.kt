@@ -0,0 +1,37 @@
+package top.kagg886.wvbridge.js.internal
+
+import kotlinx.serialization.json.JsonElement
+import kotlinx.serialization.json.JsonPrimitive
+import top.kagg886.wvbridge.js.protocol.JSValue
+
+/**
+ * Embeds this string into generated JavaScript as a string literal.
+ *
+ * JSON string syntax is a subset of JavaScript string literal syntax, so the page parses the value
+ * directly instead of decoding a Base64 payload at runtime.
+ */
+internal fun String.toJavaScriptStringLiteral(): String = JsonPrimitive(this).toJavaScriptLiteral()
+
+/**
+ * Embeds this JSON value into generated JavaScript as an object/array/primitive literal.
+ *
+ * U+2028 and U+2029 are valid inside JSON strings but were line terminators in JavaScript before
+ * ES2019. They can only occur inside JSON strings, so escaping them in the whole text is safe.
+ */
+internal fun JsonElement.toJavaScriptLiteral(): String = toString()
+    .replace("\u2028", "\\u2028")
+    .replace("\u2029", "\\u2029")
+
+/**
+ * Removes one level of JSON string quoting added by transports that JSON-encode script results,
+ * such as Android `evaluateJavascript` and WebView2 `ExecuteScript`.
+ */
+internal fun String.unwrapWebViewStringLiteral(): String {
+    if (length < 2 || first() != '"' || last() != '"') return this
+
+    return runCatching {
+        JSValue.JsonCodec.decodeFromString<String>(this)
+    }.getOrElse {
+        this
+    }
+}
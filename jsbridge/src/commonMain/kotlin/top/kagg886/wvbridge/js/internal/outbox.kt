@@ -0,0 +1,124 @@
+package top.kagg886.wvbridge.js.internal
+
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.currentCoroutineContext
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import kotlinx.coroutines.yield
+import kotlinx.serialization.json.JsonPrimitive
+import kotlinx.serialization.json.booleanOrNull
+import kotlinx.serialization.json.jsonArray
+import kotlin.coroutines.ContinuationInterceptor
+import top.kagg886.wvbridge.bridge.JavaScriptBridge
+import top.kagg886.wvbridge.js.protocol.JSValue
+
+/**
+ * Outbound Kotlin-to-JavaScript call queue of one [JavaScriptBridgeSession].
+ *
+ * Calls are JavaScript function bodies that return `true` when the message was delivered. Calls
+ * queued while a batch is being evaluated, or before the flusher gets to run, are sent together
+ * through `window.__wvbridge__.runBatch` in a single evaluation and are executed in order. Each
+ * caller suspends until its own entry of the batch result is known.
+ *
+ * The flusher only runs while calls are pending, so the queue does not keep the bridge alive. It
+ * runs on the dispatcher of the call that started it, falling back to [Dispatchers.Main], because
+ * backends such as WKWebView must only be driven from the thread that owns the WebView.
+ */
+internal class JavaScriptBridgeOutbox(private val session: JavaScriptBridgeSession) {
+    private class Entry(val body: String) {
+        val result = CompletableDeferred<Boolean>()
+    }
+
+    private val scope = CoroutineScope(SupervisorJob())
+    private val lock = Mutex()
+    private val pending = ArrayList<Entry>()
+    private var flushing = false
+
+    /**
+     * Queues [body] and suspends until the batch containing it has been evaluated.
+     *
+     * @return the value returned by [body], `true` when the message was delivered.
+     * @throws IllegalStateException when [body] threw in the page.
+     */
+    suspend fun send(bridge: JavaScriptBridge, body: String, apiName: String): Boolean {
+        val entry = Entry(body)
+        val startFlusher = lock.withLock {
+            pending += entry
+            if (flushing) {
+                false
+            } else {
+                flushing = true
+                true
+            }
+        }
+
+        if (startFlusher) {
+            val dispatcher = currentCoroutineContext()[ContinuationInterceptor] ?: Dispatchers.Main
+            scope.launch(dispatcher) { flush(bridge) }
+        }
+
+        return try {
+            entry.result.await()
+        } catch (error: IllegalStateException) {
+            throw IllegalStateException("$apiName failed: ${error.message}", error)
+        }
+    }
+
+    private suspend fun flush(bridge: JavaScriptBridge) {
+        yield()
+
+        while (true) {
+            val batch = lock.withLock {
+                if (pending.isEmpty()) {
+                    flushing = false
+                    return
+                }
+
+                val batch = pending.take(MaxOutboundBatchSize)
+                pending.subList(0, batch.size).clear()
+                batch
+            }
+
+            runCatching {
+                val script = runtimeScript(
+                    script = batch.joinToString(
+                        separator = ",\n",
+                        prefix = "return window.__wvbridge__.runBatch([\n",
+                        postfix = "\n]);",
+                    ) { "() => {\n${it.body}\n}" }
+                )
+
+                val result = session.evaluate(bridge, script)
+                    ?.unwrapWebViewStringLiteral()
+                    ?: error("runBatch returned null")
+
+                JSValue.JsonCodec.parseToJsonElement(result).jsonArray
+            }.onSuccess { results ->
+                batch.forEachIndexed { index, entry ->
+                    val value = results.getOrNull(index) as? JsonPrimitive
+                    when {
+                        value == null -> entry.result.completeExceptionally(
+                            IllegalStateException("missing batch result at index $index")
+                        )
+
+                        value.isString -> entry.result.completeExceptionally(
+                            IllegalStateException(value.content)
+                        )
+
+                        else -> entry.result.complete(value.booleanOrNull == true)
+                    }
+                }
+            }.onFailure { error ->
+                batch.forEach { it.result.completeExceptionally(error) }
+            }
+        }
+    }
+
+    private companion object {
+        const val MaxOutboundBatchSize = 256
+    }
+}
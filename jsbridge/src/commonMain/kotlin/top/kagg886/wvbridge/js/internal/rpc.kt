@@ -0,0 +1,88 @@
+package top.kagg886.wvbridge.js.internal
+
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import top.kagg886.wvbridge.bridge.JavaScriptBridge
+import top.kagg886.wvbridge.js.protocol.JSPacket
+import top.kagg886.wvbridge.js.protocol.JSValue
+import kotlin.concurrent.Volatile
+import kotlin.concurrent.atomics.AtomicReference
+import kotlin.concurrent.atomics.ExperimentalAtomicApi
+import kotlin.uuid.ExperimentalUuidApi
+import kotlin.uuid.Uuid
+
+/**
+ * Request/response channel used by `postMessageAndReceiveResult`.
+ *
+ * One native web-message handler is registered per bridge for the lifetime of the view. Each call
+ * takes a random 128-bit correlation ID and waits on its entry in the pending-call table; the page
+ * answers with `window.__wvbridge__.postResult(id, result)`, which posts a
+ * [JavaScriptBridgeResultPacketType] packet carrying the ID and the result. The IDs cannot be
+ * guessed, so other scripts in the page cannot complete a call they were not handed, and results
+ * for IDs that are not pending are ignored.
+ */
+@OptIn(ExperimentalAtomicApi::class, ExperimentalUuidApi::class)
+internal class JavaScriptBridgeRpc {
+    /**
+     * A pending call. [close] must be called once the caller stops waiting, including on timeout.
+     */
+    inner class Call(val id: String) {
+        val result = CompletableDeferred<JSValue>()
+
+        fun close() {
+            update { it - id }
+        }
+    }
+
+    private val handlerLock = Mutex()
+
+    @Volatile
+    private var handlerRegistered = false
+
+    private val pending = AtomicReference<Map<String, Call>>(emptyMap())
+
+    /**
+     * Registers the persistent response handler on [bridge] if this has not happened yet.
+     */
+    suspend fun ensureRegistered(bridge: JavaScriptBridge) {
+        if (handlerRegistered) return
+
+        handlerLock.withLock {
+            if (handlerRegistered) return
+            bridge.registerWebMessageHandler { message -> onMessage(message) }
+            handlerRegistered = true
+        }
+    }
+
+    /**
+     * Allocates a correlation ID and adds it to the pending-call table.
+     */
+    fun open(): Call {
+        val call = Call(Uuid.random().toHexString())
+        update { it + (call.id to call) }
+        return call
+    }
+
+    private fun onMessage(message: String) {
+        val packets = runCatching {
+            with(JSPacket) {
+                message.toJSPackets()
+            }
+        }.getOrNull() ?: return
+
+        for (packet in packets) {
+            if (packet.type != JavaScriptBridgeResultPacketType) continue
+
+            val id = (packet.messages.firstOrNull() as? JSValue.ScriptObject)?.value ?: continue
+            pending.load()[id]?.result?.complete(packet.messages.getOrNull(1) ?: JSValue.Undefined)
+        }
+    }
+
+    private inline fun update(transform: (Map<String, Call>) -> Map<String, Call>) {
+        while (true) {
+            val current = pending.load()
+            if (pending.compareAndSet(current, transform(current))) return
+        }
+    }
+}
@@ -0,0 +1,95 @@
+package top.kagg886.wvbridge.js.internal
+
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import top.kagg886.wvbridge.bridge.JavaScriptBridge
+import kotlin.concurrent.Volatile
+import kotlin.concurrent.atomics.AtomicLong
+import kotlin.concurrent.atomics.ExperimentalAtomicApi
+
+/**
+ * Per-[JavaScriptBridge] state shared by all jsbridge extension functions.
+ *
+ * A session never references its bridge, so it can be stored in a weak map keyed by the bridge
+ * and disappears together with the WebView.
+ */
+@OptIn(ExperimentalAtomicApi::class)
+internal class JavaScriptBridgeSession {
+    private val hookLock = Mutex()
+    @Volatile
+    private var hookRegistered = false
+
+    /**
+     * Queue shared by all outbound Kotlin-to-JavaScript message dispatches of this bridge.
+     */
+    val outbox = JavaScriptBridgeOutbox(this)
+
+    /**
+     * Request/response channel shared by all `postMessageAndReceiveResult` calls of this bridge.
+     */
+    val rpc = JavaScriptBridgeRpc()
+
+    private val nextScriptId = AtomicLong(0)
+
+    /**
+     * Allocates an ID for a script compiled with `compileScript`.
+     */
+    fun nextScriptId(): Long = nextScriptId.incrementAndFetch()
+
+    /**
+     * Makes sure [WebViewBridgeExtInstallScript] is registered as a document-start hook exactly
+     * once for [bridge], and that the runtime exists in the current page.
+     *
+     * Once the hook is registered every later document gets the runtime before its own scripts, so
+     * repeated calls return without touching the WebView.
+     */
+    suspend fun ensureInstalled(bridge: JavaScriptBridge) {
+        if (hookRegistered) return
+
+        hookLock.withLock {
+            if (hookRegistered) return
+            bridge.registerDocumentStartHook(WebViewBridgeExtInstallScript)
+            hookRegistered = true
+        }
+        bridge.evaluateScript(WebViewBridgeExtInstallScript)
+    }
+
+    /**
+     * Evaluates a script built with [runtimeScript].
+     *
+     * When the page reports that the runtime is missing (for example a document that started
+     * loading before the hook was registered), the runtime is installed and the script is retried
+     * once. This keeps the common path to a single evaluation.
+     */
+    suspend fun evaluate(bridge: JavaScriptBridge, script: String): String? {
+        val result = bridge.evaluateScript(script)
+        if (result?.unwrapWebViewStringLiteral() != JavaScriptBridgeRuntimeMissing) {
+            return result
+        }
+
+        if (hookRegistered) {
+            bridge.evaluateScript(WebViewBridgeExtInstallScript)
+        } else {
+            ensureInstalled(bridge)
+        }
+        return bridge.evaluateScript(script)
+    }
+}
+
+/**
+ * Returns the [JavaScriptBridgeSession] associated with this bridge, creating it on first use.
+ */
+internal expect val JavaScriptBridge.session: JavaScriptBridgeSession
+
+/**
+ * Wraps [script] as an IIFE that first checks for `window.__wvbridge__`.
+ *
+ * If the runtime is missing the IIFE returns [JavaScriptBridgeRuntimeMissing] instead of running
+ * [script], which lets [JavaScriptBridgeSession.evaluate] detect a fresh document in-band.
+ */
+internal fun runtimeScript(script: String): String = iife(
+    script = """
+        if (window.__wvbridge__ === undefined) return "$JavaScriptBridgeRuntimeMissing";
+        $script
+    """.trimIndent()
+)
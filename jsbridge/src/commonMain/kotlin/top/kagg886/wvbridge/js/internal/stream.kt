@@ -0,0 +1,155 @@
+package top.kagg886.wvbridge.js.internal
+
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.flow
+import kotlinx.coroutines.launch
+import top.kagg886.wvbridge.bridge.JavaScriptBridge
+import top.kagg886.wvbridge.js.protocol.JavaScriptBridgeStreamHandler
+import kotlin.concurrent.atomics.AtomicReference
+import kotlin.concurrent.atomics.ExperimentalAtomicApi
+import kotlin.io.encoding.Base64
+
+/**
+ * Receiving side of `window.wvbridge.openStream(type)` for one `registerStreamHandler` call.
+ *
+ * The page sends `wvbridge-js-stream-v2:<operation>:<id>:<payload>` frames, where operation is
+ * `open` (payload is the stream type), `data` (payload is one Base64 chunk), `end`, or `abort`
+ * (payload is the reason). Data frames are queued as strings and only decoded by the collector, so
+ * the native message callback does constant work per chunk.
+ *
+ * A stream may have at most [JavaScriptBridgeStreamInitialCredit] undelivered chunks. Credit is
+ * returned to the page in batches after the collector has consumed chunks, which bounds the memory
+ * held per stream and makes the page wait when Kotlin falls behind.
+ */
+@OptIn(ExperimentalAtomicApi::class)
+internal class JavaScriptBridgeStreamReceiver(
+    private val bridge: JavaScriptBridge,
+    private val type: String,
+    private val handle: JavaScriptBridgeStreamHandler,
+    private val scope: CoroutineScope,
+) {
+    private val streams = AtomicReference<Map<String, Channel<String>>>(emptyMap())
+
+    fun onMessage(message: String) {
+        val value = message.unwrapWebViewStringLiteral()
+        if (!value.startsWith(JavaScriptBridgeStreamHeader)) return
+
+        val operationStart = JavaScriptBridgeStreamHeader.length + 1
+        val idStart = value.indexOf(':', operationStart) + 1
+        if (idStart == 0) return
+        val payloadStart = value.indexOf(':', idStart) + 1
+        if (payloadStart == 0) return
+
+        val id = value.substring(idStart, payloadStart - 1)
+        when (value.substring(operationStart, idStart - 1)) {
+            "open" -> if (value.substring(payloadStart) == type) open(id)
+            "data" -> {
+                val channel = streams.load()[id] ?: return
+                if (channel.trySend(value.substring(payloadStart)).isFailure) {
+                    remove(id)?.close(IllegalStateException("page exceeded the stream credit"))
+                    cancelInPage(id, "wvbridge stream credit exceeded")
+                }
+            }
+
+            "end" -> remove(id)?.close()
+            "abort" -> remove(id)?.close(
+                IllegalStateException("stream aborted by the page: ${value.substring(payloadStart)}")
+            )
+        }
+    }
+
+    private fun open(id: String) {
+        val channel = Channel<String>(JavaScriptBridgeStreamInitialCredit)
+        update { it + (id to channel) }
+
+        scope.launch {
+            try {
+                handle.handle(channel.toChunkFlow(id))
+                if (remove(id) != null) {
+                    cancelInPage(id, "wvbridge stream handler returned before the stream ended")
+                }
+            } catch (error: CancellationException) {
+                remove(id)
+                throw error
+            } catch (error: Throwable) {
+                if (remove(id) != null) {
+                    cancelInPage(id, error.message ?: error.toString())
+                }
+            } finally {
+                channel.cancel()
+            }
+        }
+    }
+
+    private fun Channel<String>.toChunkFlow(id: String): Flow<ByteArray> = flow {
+        var consumed = 0
+        for (chunk in this@toChunkFlow) {
+            emit(Base64.decode(chunk))
+
+            consumed++
+            if (consumed >= JavaScriptBridgeStreamInitialCredit / 2) {
+                grant(id, consumed)
+                consumed = 0
+            }
+        }
+    }
+
+    private suspend fun grant(id: String, credit: Int) {
+        runCatching {
+            bridge.session.outbox.send(
+                bridge = bridge,
+                body = "return window.__wvbridge__.grantStreamCredit(${id.toJavaScriptStringLiteral()}, $credit);",
+                apiName = "JavaScriptBridge.registerStreamHandler",
+            )
+        }
+    }
+
+    private fun cancelInPage(id: String, reason: String, scope: CoroutineScope = this.scope) {
+        scope.launch {
+            runCatching {
+                bridge.session.outbox.send(
+                    bridge = bridge,
+                    body = "return window.__wvbridge__.cancelStream(" +
+                        "${id.toJavaScriptStringLiteral()}, ${reason.toJavaScriptStringLiteral()});",
+                    apiName = "JavaScriptBridge.registerStreamHandler",
+                )
+            }
+        }
+    }
+
+    /**
+     * Cancels every open stream on both sides. Called when the registration is closed, after which
+     * [scope] is no longer usable, so the page-side cancellation is sent from a detached scope on
+     * the same dispatcher.
+     */
+    fun closeAll() {
+        val open = streams.exchange(emptyMap())
+        if (open.isEmpty()) return
+
+        val detached = CoroutineScope(scope.coroutineContext.minusKey(Job))
+        open.forEach { (id, channel) ->
+            channel.cancel()
+            cancelInPage(id, "wvbridge stream handler was closed", detached)
+        }
+    }
+
+    private fun remove(id: String): Channel<String>? {
+        var removed: Channel<String>? = null
+        update {
+            removed = it[id]
+            it - id
+        }
+        return removed
+    }
+
+    private inline fun update(transform: (Map<String, Channel<String>>) -> Map<String, Channel<String>>) {
+        while (true) {
+            val current = streams.load()
+            if (streams.compareAndSet(current, transform(current))) return
+        }
+    }
+}
@@ -7,7 +7,15 @@ package top.kagg886.wvbridge.js.internal
  * ================================================
  */
 
-internal const val JavaScriptBridgeValueHeader: String = "wvbridge-js-value-v1"
-internal const val JavaScriptBridgePacketHeader: String = "wvbridge-js-packet-v1"
+internal const val JavaScriptBridgeValueHeaderV1: String = "wvbridge-js-value-v1"
+internal const val JavaScriptBridgePacketHeaderV1: String = "wvbridge-js-packet-v1"
+internal const val JavaScriptBridgeValueHeader: String = "wvbridge-js-value-v2"
+internal const val JavaScriptBridgePacketHeader: String = "wvbridge-js-packet-v2"
+internal const val JavaScriptBridgeBatchHeader: String = "wvbridge-js-batch-v2"
 internal const val JavaScriptBridgeReplyTokenPrefix: String = "__wvbridge_reply__:"
-internal const val JavaScriptBridgeResultTokenPrefix: String = "__wvbridge_result__:"
+internal const val JavaScriptBridgeResultPacketType: String = "__wvbridge_result__"
+internal const val JavaScriptBridgeRuntimeMissing: String = "wvbridge-runtime-missing"
+internal const val JavaScriptBridgeScriptMissing: String = "wvbridge-script-missing"
+internal const val JavaScriptBridgeStreamHeader: String = "wvbridge-js-stream-v2"
+internal const val JavaScriptBridgeStreamChunkSize: Int = 64 * 1024
+internal const val JavaScriptBridgeStreamInitialCredit: Int = 16
@@ -14,7 +14,11 @@ package top.kagg886.wvbridge.js.internal
  *
  * | Method | Purpose | Parameters | Return value |
  * |--------|---------|------------|--------------|
- * | `postMessage(type, ...messages)` | Sends a typed packet from JavaScript to native code. Kotlin receives it through `JavaScriptBridge.registerWebMessageHandler(type)`. | `type`: packet type, converted with `String(type)`. `messages`: payload values. Each value is normalized to a `JSValue` shape before being sent. | `undefined`. Throws when no native postMessage transport is available. |
+ * | `postMessage(type, ...messages)` | Sends a typed packet from JavaScript to native code. Kotlin receives it through `JavaScriptBridge.registerWebMessageHandler(type)`. | `type`: packet type, converted with `String(type)`. `messages`: payload values. Each value is normalized to a `JSValue` shape before being sent. | `undefined`. Throws when no native postMessage transport is available. With batching enabled, the packet is queued and transport errors surface from the flush instead. |
+ * | `configureBatching(options)` | Enables or disables JavaScript-to-native batching. Queued packets are sent as one batch message when the current microtask or animation frame ends; Kotlin unpacks batches transparently. | `options`: `{ mode, latestOnly }` where `mode` is `"microtask"` or `"frame"` and `latestOnly` is an array of packet types for which only the last queued packet is kept, at the position it was queued. `null` / `false` disables batching. | `undefined`. Pending packets are flushed when batching is disabled. |
+ * | `flush()` | Sends queued packets immediately. | None. | `undefined`. |
+ * | `trustedJson(value)` | Marks a value the caller guarantees to be plain JSON data. Objects are serialized with `JSON.stringify` as `JSValue.Serializable` without the fidelity check; primitives and `null` are normalized as if unwrapped. | `value`: JSON-compatible value. | Opaque wrapper accepted wherever message values are accepted. |
+ * | `openStream(type, options)` | Opens a byte stream to native code. Kotlin receives it as a `Flow<ByteArray>` through `JavaScriptBridge.registerStreamHandler(type)`. Writes wait for credit granted by Kotlin as it consumes chunks. | `type`: stream type. `options`: `{ chunkSize }`, the maximum bytes per chunk, 64 KiB by default. | `{ id, write(chunk), close(), abort(reason) }`. `write` accepts strings (sent as UTF-8), `ArrayBuffer`s and `ArrayBuffer` views; `write` and `close` return promises that reject when native code cancels the stream. |
  * | `postMessageAndReceiveResult(type, options)` | Sends a typed packet from JavaScript to native code and waits for Kotlin to call the generated reply function. Kotlin receives it through `JavaScriptBridge.registerWebMessageHandlerWithReply(type)`. | `type`: packet type. `options`: `{ timeout, args, success, error }`; `args` is an array appended to the packet before the internal reply token. | `undefined`. Calls `success(result)` on reply or `error(error)` on timeout / setup failure. |
  * | `addEventListener(type, listener)` | Registers a JavaScript listener for messages dispatched from native code with `JavaScriptBridge.postMessage(type, ...values)`. | `type`: event type, converted with `String(type)`. `listener`: function called as `listener.call(window.wvbridge, ...args)`. | `undefined`. Throws `TypeError` if `listener` is not a function. |
  * | `removeEventListener(type, listener)` | Removes a previously registered listener for the given type. | `type`: event type. `listener`: the same function reference passed to `addEventListener`. | `undefined`. Missing listeners are ignored. |
@@ -24,16 +28,28 @@ package top.kagg886.wvbridge.js.internal
  *
  * | Member | Purpose | Parameters | Return value |
  * |--------|---------|------------|--------------|
- * | `valueHeader` | Wire header for values returned by `evaluateScriptValue`. | None. | `"wvbridge-js-value-v1"`. |
- * | `packetHeader` | Wire header for message packets sent from JavaScript to native code. | None. | `"wvbridge-js-packet-v1"`. |
- * | `encodeBase64(value)` | Encodes a UTF-8 string for transport. | `value`: string. | Base64 string. |
+ * | `valueHeader` | Wire header for values returned by `evaluateScriptValue`. | None. | `"wvbridge-js-value-v2"`. |
+ * | `packetHeader` | Wire header for message packets sent from JavaScript to native code. | None. | `"wvbridge-js-packet-v2"`. |
+ * | `batchHeader` | Wire header for a batch of packets sent by `configureBatching` mode. | None. | `"wvbridge-js-batch-v2"`. |
+ * | `streamHeader` | Wire header for stream frames sent by `openStream`. | None. | `"wvbridge-js-stream-v2"`. |
+ * | `encodeBase64(value)` | Encodes a UTF-8 string for the legacy v1 wire format. | `value`: string. | Base64 string. |
  * | `decodeBase64(value)` | Decodes a UTF-8 Base64 string. | `value`: Base64 string. | Decoded string. |
  * | `toErrorValueObject(error)` | Converts a thrown JavaScript error to a `JSValue.Error`-compatible object. | `error`: any thrown value. | `{ kind: "error", stacktrace: string }`. |
- * | `toJSValueObject(value)` | Normalizes a JavaScript value to the JSON model decoded by Kotlin `JSValue`. | `value`: any JavaScript value. | One of `{ kind: "undefined" }`, `{ kind: "null" }`, `{ kind: "serializable", value }`, or `{ kind: "scriptObject", type, value }`. |
- * | `wrapWire(header, payload)` | Builds the string wire format used by Kotlin decoders. | `header`: protocol header. `payload`: JSON-serializable object. | `"<header>:<base64(json)>"`. |
- * | `toPacketWithValues(type, messages)` | Builds a packet using already-normalized `JSValue` objects. | `type`: packet type. `messages`: normalized `JSValue` objects. | Wire string with `packetHeader`. |
- * | `toPacket(type, messages)` | Builds a packet from arbitrary JavaScript values. | `type`: packet type. `messages`: any JavaScript values. | Wire string with `packetHeader`. |
- * | `postToNative(message)` | Sends a raw wire string through the platform WebView bridge. It tries WebView2, WebKit, then AndroidX WebKit transports. | `message`: raw string to send. | `undefined`. Throws if no supported transport exists. |
+ * | `toJSValueJson(value)` | Normalizes a JavaScript value to the JSON text decoded by Kotlin `JSValue`. Objects are validated and serialized in a single walk; values wrapped with `wvbridge.trustedJson` skip validation. | `value`: any JavaScript value. | JSON text of `{ kind: "undefined" }`, `{ kind: "null" }`, `{ kind: "serializable", value }`, or `{ kind: "scriptObject", type, value }`. |
+ * | `toJSValueObject(value)` | Object form of `toJSValueJson` for structured transports. Runs the same validating walk without building text; serializable values are returned as is for the transport to serialize. | `value`: any JavaScript value. | The same `JSValue` shape as `toJSValueJson`, as an object. |
+ * | `wrapJson(header, payload)` | Builds the v2 string wire format used by Kotlin decoders. | `header`: protocol header. `payload`: JSON-serializable object. | `"<header>:<json>"`. |
+ * | `wrapWire(header, payload)` | Builds the legacy v1 string wire format. | `header`: protocol header. `payload`: JSON-serializable object. | `"<header>:<base64(json)>"`. |
+ * | `structuredTransport` | Whether the current native transport accepts posted objects and forwards them as JSON. Only WebView2 does. | None. | `boolean`. |
+ * | `toPacket(type, messages)` | Builds a packet from arbitrary JavaScript values. | `type`: packet type. `messages`: any JavaScript values. | `{ header, type, messages }` on a structured transport, otherwise a wire string with `packetHeader` built by string concatenation. |
+ * | `toBatch(packetJsons)` | Builds a batch from packet JSON texts. Batched packets are always carried as text, so values are captured when `postMessage` is called rather than when the batch is flushed. | `packetJsons`: `{ type, messages }` JSON texts. | Wire string with `batchHeader`. |
+ * | `postResult(id, result)` | Answers a native `postMessageAndReceiveResult` call. | `id`: correlation ID generated by Kotlin. `result`: any JavaScript value. | `undefined`. |
+ * | `compileScript(id, source)` | Compiles `source` as a function body with one `args` parameter and caches it under `id`. | `id`: script ID allocated by Kotlin. `source`: function body. | Value wire string: `undefined`, or an error when `source` does not compile. |
+ * | `invokeScript(id, args)` | Calls a cached script with `this` bound to `globalThis`. | `id`: script ID. `args`: argument array. | Value wire string of the result, or `"$JavaScriptBridgeScriptMissing"` when `id` is unknown in this document. |
+ * | `disposeScript(id)` | Drops a cached script. | `id`: script ID. | `true` when `id` was cached in this document. |
+ * | `grantStreamCredit(id, credit)` | Lets an `openStream` writer send `credit` more chunks. | `id`: stream ID. `credit`: number of chunks. | `true` when the stream is still open. |
+ * | `cancelStream(id, reason)` | Fails an `openStream` writer from native code; pending and later writes reject. | `id`: stream ID. `reason`: error message. | `true` when the stream was still open. |
+ * | `runBatch(calls)` | Runs queued Kotlin-to-JavaScript dispatches in order. Used by the native-side outbound queue. | `calls`: array of functions, each returning `true` when its message was delivered. | JSON array string; each entry is the call's boolean result or the stack trace string when it threw. |
+ * | `postToNative(message)` | Sends a packet through the platform WebView bridge. It tries WebView2, WebKit, then AndroidX WebKit transports. | `message`: wire string, or packet object on a structured transport. | `undefined`. Throws if no supported transport exists. |
  */
 internal val WebViewBridgeExtInstallScript: String = iife(
     script = """
@@ -62,81 +78,67 @@ internal val WebViewBridgeExtInstallScript: String = iife(
             }
         };
 
-        const isPlainJsonObject = (value) => {
-            if (value === null || typeof value !== "object") return false;
-            const proto = Object.getPrototypeOf(value);
-            return proto === Object.prototype || proto === null;
-        };
-
-        const isArrayIndexName = (name) => {
-            if (name === "length") return true;
-
-            const index = Number(name);
-            return Number.isInteger(index)
-                && index >= 0
-                && index < 4294967295
-                && String(index) === name;
-        };
-
-        const isStrictJsonEquivalent = (source, parsed, seen = new WeakSet()) => {
-            if (source === null) return parsed === null;
-
-            const type = typeof source;
-
-            if (type === "string" || type === "boolean") return source === parsed;
-
-            if (type === "number") {
-                return typeof parsed === "number"
-                    && Number.isFinite(source)
-                    && Object.is(source, parsed);
+        const jsonObjectPrototype = Object.prototype;
+
+        // Serializes value as JSON text in one walk, returning undefined as soon as the value
+        // would not survive a JSON round trip unchanged (accessors, holes, extra array properties,
+        // symbols, non-plain prototypes, non-finite numbers, -0, shared or cyclic references).
+        // With build set to false it only validates and returns "" for a valid value.
+        const encodeStrictJson = (value, seen, build = true) => {
+            if (value === null) return build ? "null" : "";
+
+            switch (typeof value) {
+                case "string":
+                    return build ? JSON.stringify(value) : "";
+                case "boolean":
+                    return build ? (value ? "true" : "false") : "";
+                case "number":
+                    if (!Number.isFinite(value) || Object.is(value, -0)) return undefined;
+                    return build ? String(value) : "";
+                case "object":
+                    break;
+                default:
+                    return undefined;
             }
 
-            if (type !== "object") return false;
-
-            if (seen.has(source)) return false;
-            seen.add(source);
+            if (seen.has(value)) return undefined;
+            seen.add(value);
 
-            if (Array.isArray(source)) {
-                if (!Array.isArray(parsed)) return false;
-                if (source.length !== parsed.length) return false;
-                if (Object.getOwnPropertySymbols(source).length !== 0) return false;
+            const isArray = Array.isArray(value);
+            if (!isArray) {
+                const proto = Object.getPrototypeOf(value);
+                if (proto !== jsonObjectPrototype && proto !== null) return undefined;
+            }
 
-                for (const name of Object.getOwnPropertyNames(source)) {
-                    if (!isArrayIndexName(name)) return false;
-                }
+            const descriptors = Object.getOwnPropertyDescriptors(value);
+            const parts = [];
+            let count = 0;
 
-                for (let i = 0; i < source.length; i++) {
-                    if (!Object.prototype.hasOwnProperty.call(source, i)) return false;
+            for (const key of Reflect.ownKeys(descriptors)) {
+                if (typeof key === "symbol") return undefined;
+                if (isArray && key === "length") continue;
 
-                    const descriptor = Object.getOwnPropertyDescriptor(source, String(i));
-                    if (!descriptor || !descriptor.enumerable || !("value" in descriptor)) return false;
+                const descriptor = descriptors[key];
+                if (!descriptor.enumerable || !("value" in descriptor)) return undefined;
+                if (isArray && key !== String(count)) return undefined;
 
-                    if (!isStrictJsonEquivalent(descriptor.value, parsed[i], seen)) return false;
-                }
+                const json = encodeStrictJson(descriptor.value, seen, build);
+                if (json === undefined) return undefined;
 
-                return true;
+                count++;
+                if (build) parts.push(isArray ? json : JSON.stringify(key) + ":" + json);
             }
 
-            if (!isPlainJsonObject(source)) return false;
-            if (!isPlainJsonObject(parsed)) return false;
-            if (Object.getOwnPropertySymbols(source).length !== 0) return false;
-
-            const sourceNames = Object.getOwnPropertyNames(source);
-            const sourceKeys = Object.keys(source);
-            const parsedKeys = Object.keys(parsed);
-
-            if (sourceNames.length !== sourceKeys.length) return false;
-            if (sourceKeys.length !== parsedKeys.length) return false;
+            if (isArray && count !== value.length) return undefined;
+            if (!build) return "";
+            return isArray ? "[" + parts.join(",") + "]" : "{" + parts.join(",") + "}";
+        };
 
-            for (const key of sourceKeys) {
-                const descriptor = Object.getOwnPropertyDescriptor(source, key);
-                if (!descriptor || !descriptor.enumerable || !("value" in descriptor)) return false;
-                if (!Object.prototype.hasOwnProperty.call(parsed, key)) return false;
-                if (!isStrictJsonEquivalent(descriptor.value, parsed[key], seen)) return false;
+        class TrustedJson {
+            constructor(value) {
+                this.value = value;
             }
-
-            return true;
-        };
+        }
 
         const toScriptObjectValueObject = (value) => {
             const type = typeof value;
@@ -158,30 +160,66 @@ internal val WebViewBridgeExtInstallScript: String = iife(
                 : toObjectString(error)
         });
 
+        const undefinedValueJson = '{"kind":"undefined"}';
+        const nullValueJson = '{"kind":"null"}';
+        const toSerializableValueJson = (json) => '{"kind":"serializable","value":' + json + "}";
+
+        const isTrustedObject = (value) =>
+            value !== null && typeof value === "object" && !(value instanceof TrustedJson);
+
+        const toJSValueJson = (value) => {
+            if (value === undefined) return undefinedValueJson;
+            if (value === null) return nullValueJson;
+
+            if (value instanceof TrustedJson) {
+                // Only objects can be serializable values; anything else takes the checked path.
+                if (!isTrustedObject(value.value)) return toJSValueJson(value.value);
+                const json = JSON.stringify(value.value);
+                return json === undefined ? undefinedValueJson : toSerializableValueJson(json);
+            }
+
+            if (typeof value !== "object") return JSON.stringify(toScriptObjectValueObject(value));
+
+            let json;
+            try {
+                json = encodeStrictJson(value, new WeakSet());
+            } catch (_) {
+                json = undefined;
+            }
+
+            return json === undefined
+                ? JSON.stringify(toScriptObjectValueObject(value))
+                : toSerializableValueJson(json);
+        };
+
         const toJSValueObject = (value) => {
             if (value === undefined) return { kind: "undefined" };
             if (value === null) return { kind: "null" };
 
-            if (typeof value !== "object") return toScriptObjectValueObject(value);
+            if (value instanceof TrustedJson) {
+                return isTrustedObject(value.value)
+                    ? { kind: "serializable", value: value.value }
+                    : toJSValueObject(value.value);
+            }
 
-            let json;
-            let parsed;
+            if (typeof value !== "object") return toScriptObjectValueObject(value);
 
+            let valid;
             try {
-                json = JSON.stringify(value);
-                if (typeof json !== "string") return toScriptObjectValueObject(value);
-
-                parsed = JSON.parse(json);
+                valid = encodeStrictJson(value, new WeakSet(), false) !== undefined;
             } catch (_) {
-                return toScriptObjectValueObject(value);
+                valid = false;
             }
 
-            return isStrictJsonEquivalent(value, parsed)
-                ? { kind: "serializable", value: parsed }
-                : toScriptObjectValueObject(value);
+            return valid ? { kind: "serializable", value } : toScriptObjectValueObject(value);
         };
 
+        const toPacketJson = (type, messageJsons) =>
+            '{"type":' + JSON.stringify(String(type)) + ',"messages":[' + messageJsons.join(",") + "]}";
+
         const messageListeners = new Map();
+        const compiledScripts = new Map();
+        const streams = new Map();
         const wvbridge = window.wvbridge || {};
         const replyTokenPrefix = "$JavaScriptBridgeReplyTokenPrefix";
 
@@ -202,20 +240,73 @@ internal val WebViewBridgeExtInstallScript: String = iife(
             return Array.from(randomValues, byte => byte.toString(16).padStart(2, "0")).join("");
         };
 
+        const structuredTransport = !!(
+            window.chrome
+            && window.chrome.webview
+            && typeof window.chrome.webview.postMessage === "function"
+        );
+
         const bridge = {
             valueHeader: "$JavaScriptBridgeValueHeader",
             packetHeader: "$JavaScriptBridgePacketHeader",
+            batchHeader: "$JavaScriptBridgeBatchHeader",
+            streamHeader: "$JavaScriptBridgeStreamHeader",
             replyTokenPrefix,
+            structuredTransport,
             encodeBase64,
             decodeBase64,
             toErrorValueObject,
             toJSValueObject,
+            toJSValueJson,
+            wrapJson: (header, payload) => header + ":" + JSON.stringify(payload),
             wrapWire: (header, payload) => header + ":" + encodeBase64(JSON.stringify(payload)),
-            toPacketWithValues: (type, messages) => bridge.wrapWire(
-                bridge.packetHeader,
-                { type: String(type), messages }
+            toPacket: (type, messages) => structuredTransport
+                ? { header: bridge.packetHeader, type: String(type), messages: messages.map(toJSValueObject) }
+                : bridge.packetHeader + ":" + toPacketJson(type, messages.map(toJSValueJson)),
+            toBatch: (packetJsons) => bridge.batchHeader + ":[" + packetJsons.join(",") + "]",
+            postResult: (id, result) => bridge.postToNative(
+                bridge.toPacket("$JavaScriptBridgeResultPacketType", [String(id), result])
             ),
-            toPacket: (type, messages) => bridge.toPacketWithValues(type, messages.map(toJSValueObject)),
+            compileScript: (id, source) => {
+                try {
+                    compiledScripts.set(id, new Function("args", source));
+                    return bridge.valueHeader + ":" + undefinedValueJson;
+                } catch (error) {
+                    return bridge.valueHeader + ":" + JSON.stringify(toErrorValueObject(error));
+                }
+            },
+            invokeScript: (id, args) => {
+                const script = compiledScripts.get(id);
+                if (script === undefined) return "$JavaScriptBridgeScriptMissing";
+
+                try {
+                    return bridge.valueHeader + ":" + toJSValueJson(script.call(globalThis, args));
+                } catch (error) {
+                    return bridge.valueHeader + ":" + JSON.stringify(toErrorValueObject(error));
+                }
+            },
+            disposeScript: (id) => compiledScripts.delete(id),
+            grantStreamCredit: (id, credit) => {
+                const stream = streams.get(id);
+                if (stream === undefined) return false;
+
+                stream.grant(credit);
+                return true;
+            },
+            cancelStream: (id, reason) => {
+                const stream = streams.get(id);
+                if (stream === undefined) return false;
+
+                stream.fail(new Error(reason));
+                return true;
+            },
+            runBatch: (calls) => JSON.stringify(calls.map((call) => {
+                try {
+                    return call() === true;
+                } catch (error) {
+                    return toErrorValueObject(error).stacktrace;
+                }
+            })),
             postToNative: (message) => {
                 if (window.chrome && window.chrome.webview && typeof window.chrome.webview.postMessage === "function") {
                     window.chrome.webview.postMessage(message);
@@ -248,8 +339,170 @@ internal val WebViewBridgeExtInstallScript: String = iife(
             return listeners;
         };
 
+        let batching = null;
+        let pendingPackets = [];
+        const latestPackets = new Map();
+        let flushScheduled = false;
+
+        const flushPackets = () => {
+            flushScheduled = false;
+            if (pendingPackets.length === 0) return;
+
+            const packets = pendingPackets.filter(packet => !packet.superseded);
+            pendingPackets = [];
+            latestPackets.clear();
+
+            bridge.postToNative(
+                packets.length === 1
+                    ? bridge.packetHeader + ":" + packets[0].json
+                    : bridge.toBatch(packets.map(packet => packet.json))
+            );
+        };
+
+        const scheduleFlush = () => {
+            if (flushScheduled) return;
+            flushScheduled = true;
+
+            if (batching.mode === "frame" && typeof requestAnimationFrame === "function") {
+                requestAnimationFrame(flushPackets);
+            } else if (batching.mode === "frame") {
+                setTimeout(flushPackets, 16);
+            } else {
+                queueMicrotask(flushPackets);
+            }
+        };
+
+        wvbridge.configureBatching = (options) => {
+            if (!options) {
+                batching = null;
+                flushPackets();
+                return;
+            }
+
+            const { mode = "microtask", latestOnly = [] } = options;
+            if (mode !== "microtask" && mode !== "frame") {
+                throw new TypeError("wvbridge.configureBatching options.mode must be \"microtask\" or \"frame\"");
+            }
+
+            if (!Array.isArray(latestOnly)) {
+                throw new TypeError("wvbridge.configureBatching options.latestOnly must be an array");
+            }
+
+            batching = { mode, latestOnly: new Set(latestOnly.map(String)) };
+        };
+
+        wvbridge.flush = flushPackets;
+
+        wvbridge.trustedJson = (value) => new TrustedJson(value);
+
+        const toStreamBytes = (chunk) => {
+            if (typeof chunk === "string") return new TextEncoder().encode(chunk);
+            if (chunk instanceof ArrayBuffer) return new Uint8Array(chunk);
+            if (ArrayBuffer.isView(chunk)) return new Uint8Array(chunk.buffer, chunk.byteOffset, chunk.byteLength);
+
+            throw new TypeError("wvbridge stream chunks must be strings, ArrayBuffers or ArrayBuffer views");
+        };
+
+        const encodeBytesBase64 = (bytes) => {
+            let binary = "";
+            for (let offset = 0; offset < bytes.length; offset += 0x8000) {
+                binary += String.fromCharCode.apply(null, bytes.subarray(offset, offset + 0x8000));
+            }
+
+            return btoa(binary);
+        };
+
+        const postStreamFrame = (operation, id, payload) =>
+            bridge.postToNative(bridge.streamHeader + ":" + operation + ":" + id + ":" + payload);
+
+        // Streams send at most one chunk per credit. Kotlin starts every stream with
+        // $JavaScriptBridgeStreamInitialCredit credits and returns them as chunks are consumed.
+        wvbridge.openStream = (type, options = {}) => {
+            const { chunkSize = $JavaScriptBridgeStreamChunkSize } = options || {};
+            if (!(chunkSize > 0)) {
+                throw new TypeError("wvbridge.openStream options.chunkSize must be a positive number");
+            }
+
+            const id = randomReplyId();
+            const state = { credit: $JavaScriptBridgeStreamInitialCredit, error: null, closed: false, waiters: [] };
+            const wake = () => state.waiters.splice(0).forEach(resolve => resolve());
+
+            state.grant = (credit) => {
+                state.credit += Number(credit);
+                wake();
+            };
+            state.fail = (error) => {
+                if (state.error !== null) return;
+                state.error = error;
+                streams.delete(id);
+                wake();
+            };
+
+            streams.set(id, state);
+            postStreamFrame("open", id, String(type));
+
+            let tail = Promise.resolve();
+            const enqueue = (task) => {
+                const result = tail.then(task);
+                tail = result.catch(() => {});
+                return result;
+            };
+
+            const ensureWritable = () => {
+                if (state.error !== null) throw state.error;
+                if (state.closed) throw new Error("wvbridge stream is closed");
+            };
+
+            return {
+                id,
+                write: (chunk) => {
+                    const bytes = toStreamBytes(chunk);
+                    return enqueue(async () => {
+                        for (let offset = 0; offset < bytes.length; offset += chunkSize) {
+                            while (state.credit <= 0 && state.error === null) {
+                                await new Promise(resolve => state.waiters.push(resolve));
+                            }
+
+                            ensureWritable();
+                            state.credit--;
+                            postStreamFrame("data", id, encodeBytesBase64(bytes.subarray(offset, offset + chunkSize)));
+                        }
+                    });
+                },
+                close: () => enqueue(() => {
+                    ensureWritable();
+                    state.closed = true;
+                    streams.delete(id);
+                    postStreamFrame("end", id, "");
+                }),
+                abort: (reason) => {
+                    if (state.error !== null || state.closed) return;
+
+                    state.fail(new Error("wvbridge stream aborted"));
+                    postStreamFrame("abort", id, toObjectString(reason));
+                }
+            };
+        };
+
         wvbridge.postMessage = (type, ...messages) => {
-            bridge.postToNative(bridge.toPacket(type, messages));
+            if (batching === null) {
+                bridge.postToNative(bridge.toPacket(type, messages));
+                return;
+            }
+
+            const packet = { type: String(type) };
+            packet.json = toPacketJson(packet.type, messages.map(toJSValueJson));
+
+            // Drop the older packet of a latest-only type and queue the new one at the end, so it is
+            // never delivered ahead of packets that were queued after the old one.
+            if (batching.latestOnly.has(packet.type)) {
+                const previous = latestPackets.get(packet.type);
+                if (previous !== undefined) previous.superseded = true;
+                latestPackets.set(packet.type, packet);
+            }
+
+            pendingPackets.push(packet);
+            scheduleFlush();
         };
 
         wvbridge.postMessageAndReceiveResult = (type, options = {}) => {
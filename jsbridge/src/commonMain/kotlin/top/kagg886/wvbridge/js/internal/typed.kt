@@ -0,0 +1,246 @@
+package top.kagg886.wvbridge.js.internal
+
+import kotlinx.serialization.DeserializationStrategy
+import kotlinx.serialization.ExperimentalSerializationApi
+import kotlinx.serialization.KSerializer
+import kotlinx.serialization.SerializationException
+import kotlinx.serialization.descriptors.SerialDescriptor
+import kotlinx.serialization.descriptors.buildClassSerialDescriptor
+import kotlinx.serialization.descriptors.element
+import kotlinx.serialization.descriptors.listSerialDescriptor
+import kotlinx.serialization.encoding.CompositeDecoder
+import kotlinx.serialization.encoding.Decoder
+import kotlinx.serialization.encoding.decodeStructure
+import kotlinx.serialization.json.JsonArray
+import kotlinx.serialization.json.JsonElement
+import kotlinx.serialization.json.JsonPrimitive
+import kotlinx.serialization.json.contentOrNull
+import kotlinx.serialization.json.jsonArray
+import kotlinx.serialization.json.jsonObject
+import kotlinx.serialization.json.jsonPrimitive
+import top.kagg886.wvbridge.js.protocol.JSValue.Companion.JsonCodec
+
+/**
+ * A `JSValue` whose serializable payload was decoded straight into `T`.
+ */
+internal sealed interface TypedJSValue<out T> {
+    class Value<T>(val value: T) : TypedJSValue<T>
+    data object Undefined : TypedJSValue<Nothing>
+    data object Null : TypedJSValue<Nothing>
+    class ScriptObject(val type: String, val value: String) : TypedJSValue<Nothing>
+    class Error(val stacktrace: String) : TypedJSValue<Nothing>
+}
+
+/**
+ * Returns the decoded value, or throws when the JavaScript value cannot be represented as `T`.
+ */
+@Suppress("UNCHECKED_CAST")
+internal fun <T> TypedJSValue<T>.getOrThrow(serializer: KSerializer<T>, apiName: String): T = when (this) {
+    is TypedJSValue.Value -> value
+    TypedJSValue.Undefined, TypedJSValue.Null -> if (serializer.descriptor.isNullable) {
+        null as T
+    } else {
+        throw IllegalArgumentException(
+            "$apiName got JavaScript $this, but ${serializer.descriptor.serialName} is not nullable"
+        )
+    }
+
+    is TypedJSValue.ScriptObject -> throw IllegalArgumentException(
+        "$apiName cannot decode JavaScript $type '$value' as ${serializer.descriptor.serialName}"
+    )
+
+    is TypedJSValue.Error -> throw IllegalStateException("$apiName failed: $stacktrace")
+}
+
+/**
+ * Decodes the `JSValue` wire object directly into [TypedJSValue], without building a JSON tree.
+ *
+ * The `serializable` payload is decoded with [valueSerializer]. JavaScript string, number, and
+ * boolean primitives, which the page sends as `scriptObject`, are converted to `T` when
+ * [valueSerializer] accepts them. The page always writes `kind` and `type` before `value`.
+ */
+internal class TypedJSValueDeserializer<T>(
+    private val valueSerializer: KSerializer<T>,
+) : DeserializationStrategy<TypedJSValue<T>> {
+    override val descriptor: SerialDescriptor = buildClassSerialDescriptor("top.kagg886.wvbridge.js.TypedJSValue") {
+        element<String>("kind")
+        element<String>("type", isOptional = true)
+        element("value", valueSerializer.descriptor, isOptional = true)
+        element<String>("stacktrace", isOptional = true)
+    }
+
+    override fun deserialize(decoder: Decoder): TypedJSValue<T> = decoder.decodeStructure(descriptor) {
+        var kind: String? = null
+        var type: String? = null
+        var value: TypedJSValue<T>? = null
+        var raw: String? = null
+        var stacktrace: String? = null
+
+        while (true) {
+            when (val index = decodeElementIndex(descriptor)) {
+                CompositeDecoder.DECODE_DONE -> break
+                0 -> kind = decodeStringElement(descriptor, index)
+                1 -> type = decodeStringElement(descriptor, index)
+                2 -> when (kind) {
+                    "serializable" -> value = TypedJSValue.Value(
+                        decodeSerializableElement(descriptor, index, valueSerializer)
+                    )
+
+                    "scriptObject" -> raw = decodeStringElement(descriptor, index)
+                    else -> throw SerializationException("JSValue field 'value' must follow its 'kind'")
+                }
+
+                3 -> stacktrace = decodeStringElement(descriptor, index)
+                else -> throw SerializationException("Unexpected JSValue field index $index")
+            }
+        }
+
+        when (kind) {
+            "serializable" -> value ?: throw SerializationException("JSValue.Serializable without value")
+            "undefined" -> TypedJSValue.Undefined
+            "null" -> TypedJSValue.Null
+            "error" -> TypedJSValue.Error(stacktrace.orEmpty())
+            "scriptObject" -> {
+                val type = type.orEmpty()
+                val raw = raw.orEmpty()
+                primitiveToValue(type, raw) ?: TypedJSValue.ScriptObject(type, raw)
+            }
+
+            else -> throw SerializationException("Unknown JSValue kind '$kind'")
+        }
+    }
+
+    private fun primitiveToValue(type: String, raw: String): TypedJSValue<T>? = runCatching {
+        when (type) {
+            "string" -> TypedJSValue.Value(JsonCodec.decodeFromJsonElement(valueSerializer, JsonPrimitive(raw)))
+            "number", "boolean" -> TypedJSValue.Value(JsonCodec.decodeFromString(valueSerializer, raw))
+            else -> null
+        }
+    }.getOrNull()
+}
+
+/**
+ * Decodes one packet into the messages of packets whose type is [expectedType], or `null` for
+ * packets of any other type.
+ *
+ * Messages of a matching packet are decoded straight from the input. If `messages` precedes
+ * `type`, the messages are buffered as a JSON tree first.
+ */
+@OptIn(ExperimentalSerializationApi::class)
+internal class TypedJSPacketDeserializer<T>(
+    private val expectedType: String,
+    valueSerializer: KSerializer<T>,
+) : DeserializationStrategy<List<TypedJSValue<T>>?> {
+    private val valueDeserializer = TypedJSValueDeserializer(valueSerializer)
+    private val messagesDeserializer = ListDeserializer(valueDeserializer)
+
+    override val descriptor: SerialDescriptor = buildClassSerialDescriptor("top.kagg886.wvbridge.js.TypedJSPacket") {
+        element<String>("type")
+        element("messages", listSerialDescriptor(valueDeserializer.descriptor))
+    }
+
+    override fun deserialize(decoder: Decoder): List<TypedJSValue<T>>? = decoder.decodeStructure(descriptor) {
+        var type: String? = null
+        var messages: List<TypedJSValue<T>>? = null
+        var bufferedMessages: JsonElement? = null
+
+        while (true) {
+            when (val index = decodeElementIndex(descriptor)) {
+                CompositeDecoder.DECODE_DONE -> break
+                0 -> type = decodeStringElement(descriptor, index)
+                1 -> if (type == null) {
+                    bufferedMessages = decodeSerializableElement(descriptor, index, JsonElement.serializer())
+                } else if (type == expectedType) {
+                    messages = decodeSerializableElement(descriptor, index, messagesDeserializer)
+                } else {
+                    decodeSerializableElement(descriptor, index, JsonElement.serializer())
+                }
+
+                else -> throw SerializationException("Unexpected packet field index $index")
+            }
+        }
+
+        if (type != expectedType) return@decodeStructure null
+        messages ?: bufferedMessages?.jsonArray?.map {
+            JsonCodec.decodeFromJsonElement(valueDeserializer, it)
+        } ?: emptyList()
+    }
+}
+
+@OptIn(ExperimentalSerializationApi::class)
+private class ListDeserializer<T>(
+    private val element: DeserializationStrategy<T>,
+) : DeserializationStrategy<List<T>> {
+    override val descriptor: SerialDescriptor = listSerialDescriptor(element.descriptor)
+
+    override fun deserialize(decoder: Decoder): List<T> = decoder.decodeStructure(descriptor) {
+        buildList {
+            while (true) {
+                val index = decodeElementIndex(descriptor)
+                if (index == CompositeDecoder.DECODE_DONE) break
+                add(decodeSerializableElement(descriptor, index, element))
+            }
+        }
+    }
+}
+
+/**
+ * Decodes an `evaluateScriptValue` result string into [TypedJSValue].
+ */
+internal fun <T> String?.toTypedJavaScriptBridgeValue(serializer: KSerializer<T>): TypedJSValue<T> {
+    if (this == null) return TypedJSValue.Undefined
+
+    val value = unwrapWebViewStringLiteral()
+    val separator = value.indexOf(':')
+    if (separator < 0) {
+        error("decode failed, result is $this")
+    }
+
+    val deserializer = TypedJSValueDeserializer(serializer)
+    return when (value.substring(0, separator)) {
+        JavaScriptBridgeValueHeader -> JsonCodec.decodeFromString(deserializer, value.substring(separator + 1))
+        JavaScriptBridgeValueHeaderV1 -> JsonCodec.decodeFromString(
+            deserializer,
+            value.substring(separator + 1).base64Decode()
+        )
+
+        else -> error("decode failed, result is $this")
+    }
+}
+
+/**
+ * Decodes a raw WebView message into the message lists of every packet of type [type].
+ *
+ * Single v2 string packets, the common case, are decoded straight from the string. Batches and
+ * structured envelopes are split into packets through a JSON tree first.
+ */
+internal fun <T> String.toTypedJSPackets(type: String, serializer: KSerializer<T>): List<List<TypedJSValue<T>>> {
+    val value = unwrapWebViewStringLiteral()
+    val deserializer = TypedJSPacketDeserializer(type, serializer)
+
+    fun JsonArray.decodePackets() = mapNotNull { JsonCodec.decodeFromJsonElement(deserializer, it) }
+
+    if (value.startsWith('{')) {
+        val envelope = JsonCodec.parseToJsonElement(value).jsonObject
+        return when (envelope["header"]?.jsonPrimitive?.contentOrNull) {
+            JavaScriptBridgeBatchHeader -> envelope["packets"]?.jsonArray?.decodePackets().orEmpty()
+            JavaScriptBridgePacketHeader -> listOfNotNull(JsonCodec.decodeFromJsonElement(deserializer, envelope))
+            else -> error("decode failed, packet is $this")
+        }
+    }
+
+    if (value.startsWith(JavaScriptBridgeStreamHeader)) return emptyList()
+
+    val separator = value.indexOf(':')
+    if (separator < 0) {
+        error("decode failed, packet is $this")
+    }
+
+    val payload = value.substring(separator + 1)
+    return when (value.substring(0, separator)) {
+        JavaScriptBridgePacketHeader -> listOfNotNull(JsonCodec.decodeFromString(deserializer, payload))
+        JavaScriptBridgeBatchHeader -> JsonCodec.parseToJsonElement(payload).jsonArray.decodePackets()
+        JavaScriptBridgePacketHeaderV1 -> listOfNotNull(JsonCodec.decodeFromString(deserializer, payload.base64Decode()))
+        else -> error("decode failed, packet is $this")
+    }
+}
@@ -0,0 +1,26 @@
+package top.kagg886.wvbridge.js.protocol
+
+import top.kagg886.wvbridge.js.internal.JavaScriptBridgeSession
+import kotlin.concurrent.Volatile
+
+/**
+ * Handle to a script compiled in the page by `JavaScriptBridge.compileScript`.
+ *
+ * The compiled function is cached in the page under [id]. Invoking the handle sends only the ID
+ * and the arguments; when the page no longer knows the ID, for example after a navigation, the
+ * script is compiled again from [source] transparently.
+ *
+ * A handle belongs to the bridge that compiled it and can only be invoked on that bridge. Call
+ * `JavaScriptBridge.dispose` to drop the compiled function from the page once it is no longer
+ * needed; a disposed handle cannot be invoked again.
+ */
+public class CompiledScript internal constructor(
+    internal val session: JavaScriptBridgeSession,
+    internal val id: Long,
+    internal val source: String,
+) {
+    @Volatile
+    internal var disposed: Boolean = false
+
+    override fun toString(): String = "CompiledScript(id=$id)"
+}
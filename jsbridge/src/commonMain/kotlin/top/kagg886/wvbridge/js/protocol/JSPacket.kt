@@ -1,10 +1,15 @@
 package top.kagg886.wvbridge.js.protocol
 
 import kotlinx.serialization.Serializable
-import kotlinx.serialization.encodeToString
+import kotlinx.serialization.json.contentOrNull
+import kotlinx.serialization.json.jsonObject
+import kotlinx.serialization.json.jsonPrimitive
+import top.kagg886.wvbridge.js.internal.JavaScriptBridgeBatchHeader
 import top.kagg886.wvbridge.js.internal.JavaScriptBridgePacketHeader
+import top.kagg886.wvbridge.js.internal.JavaScriptBridgePacketHeaderV1
+import top.kagg886.wvbridge.js.internal.JavaScriptBridgeStreamHeader
 import top.kagg886.wvbridge.js.internal.base64Decode
-import top.kagg886.wvbridge.js.internal.base64Encode
+import top.kagg886.wvbridge.js.internal.unwrapWebViewStringLiteral
 import top.kagg886.wvbridge.js.protocol.JSValue.Companion.JsonCodec
 
 @Serializable
@@ -12,27 +17,83 @@ internal data class JSPacket(
     val type: String,
     val messages: List<JSValue>,
 ) {
+    /**
+     * Structured form of a v2 packet, used when the native transport forwards the posted object
+     * as JSON instead of a string.
+     */
+    @Serializable
+    private data class Envelope(
+        val header: String,
+        val type: String,
+        val messages: List<JSValue>,
+    )
+
+    /**
+     * Structured form of a v2 batch.
+     */
+    @Serializable
+    private data class BatchEnvelope(
+        val header: String,
+        val packets: List<JSPacket>,
+    )
+
     internal companion object {
+        /**
+         * Decodes a raw WebView message that may carry several packets.
+         *
+         * Besides the single-packet formats accepted by [toJSPacket], this accepts the batches sent
+         * by `window.wvbridge.configureBatching`: `wvbridge-js-batch-v2:<json array>` and its
+         * structured `{"header":"wvbridge-js-batch-v2","packets":[...]}` form. Stream frames sent by
+         * `window.wvbridge.openStream` are not packets and decode to an empty list.
+         */
+        internal fun String.toJSPackets(): List<JSPacket> {
+            val value = unwrapWebViewStringLiteral()
+            if (value.startsWith('{')) {
+                // Parse the structured form once and decode whichever envelope it turns out to be.
+                val envelope = JsonCodec.parseToJsonElement(value).jsonObject
+                return when (envelope["header"]?.jsonPrimitive?.contentOrNull) {
+                    JavaScriptBridgeBatchHeader -> JsonCodec.decodeFromJsonElement<BatchEnvelope>(envelope).packets
+                    JavaScriptBridgePacketHeader -> JsonCodec.decodeFromJsonElement<Envelope>(envelope)
+                        .let { listOf(JSPacket(it.type, it.messages)) }
+
+                    else -> error("decode failed, packet is $this")
+                }
+            } else if (value.startsWith("$JavaScriptBridgeBatchHeader:")) {
+                return JsonCodec.decodeFromString(value.substring(JavaScriptBridgeBatchHeader.length + 1))
+            } else if (value.startsWith(JavaScriptBridgeStreamHeader)) {
+                return emptyList()
+            }
+
+            return listOf(toJSPacket())
+        }
+
+        /**
+         * Decodes a raw WebView message into a [JSPacket].
+         *
+         * Accepted wire formats:
+         * - `wvbridge-js-packet-v2:<json>`: plain JSON after a fixed header.
+         * - `{"header":"wvbridge-js-packet-v2",...}`: the v2 packet posted as a structured value.
+         * - `wvbridge-js-packet-v1:<base64(json)>`: legacy format kept for compatibility.
+         */
         internal fun String.toJSPacket(): JSPacket {
             val value = unwrapWebViewStringLiteral()
-            val separator = value.indexOf(':')
-            if (separator < 0) {
-                error("decode failed, packet is $this")
+            if (value.startsWith('{')) {
+                val envelope = JsonCodec.decodeFromString<Envelope>(value)
+                if (envelope.header != JavaScriptBridgePacketHeader) {
+                    error("decode failed, packet is $this")
+                }
+                return JSPacket(envelope.type, envelope.messages)
             }
 
-            val header = value.substring(0, separator)
-            if (header != JavaScriptBridgePacketHeader) {
+            val separator = value.indexOf(':')
+            if (separator < 0) {
                 error("decode failed, packet is $this")
             }
 
-            val json = value.substring(separator + 1).base64Decode()
-            return JsonCodec.decodeFromString(json)
-        }
-        private fun String.unwrapWebViewStringLiteral(): String {
-            return runCatching {
-                JsonCodec.decodeFromString<String>(this)
-            }.getOrElse {
-                this
+            return when (value.substring(0, separator)) {
+                JavaScriptBridgePacketHeader -> JsonCodec.decodeFromString(value.substring(separator + 1))
+                JavaScriptBridgePacketHeaderV1 -> JsonCodec.decodeFromString(value.substring(separator + 1).base64Decode())
+                else -> error("decode failed, packet is $this")
             }
         }
     }
@@ -0,0 +1,14 @@
+package top.kagg886.wvbridge.js.protocol
+
+import kotlinx.coroutines.flow.Flow
+
+/**
+ * Handles a byte stream opened with `window.wvbridge.openStream(type)`.
+ *
+ * [stream] emits the chunks written by the page, in order, and completes when the page calls
+ * `close()`. It fails with [IllegalStateException] when the page calls `abort(reason)`. Collect it
+ * once; returning before the stream completes cancels it in the page.
+ */
+public fun interface JavaScriptBridgeStreamHandler {
+    public suspend fun handle(stream: Flow<ByteArray>)
+}
@@ -0,0 +1,9 @@
+package top.kagg886.wvbridge.js.protocol
+
+/**
+ * Handles JavaScript messages posted with `window.wvbridge.postMessage(type, ...messages)` whose
+ * payload values are decoded directly into [T].
+ */
+public fun interface JavaScriptBridgeTypedMessageHandler<T> {
+    public fun handle(values: List<T>)
+}
@@ -10,7 +10,9 @@ import kotlinx.serialization.json.encodeToJsonElement
 import kotlinx.serialization.serializer
 import kotlinx.serialization.Serializable as KotlinSerializable
 import top.kagg886.wvbridge.js.internal.JavaScriptBridgeValueHeader
+import top.kagg886.wvbridge.js.internal.JavaScriptBridgeValueHeaderV1
 import top.kagg886.wvbridge.js.internal.base64Decode
+import top.kagg886.wvbridge.js.internal.unwrapWebViewStringLiteral
 import kotlin.reflect.KClass
 
 /**
@@ -69,6 +71,12 @@ public sealed interface JSValue {
             encodeDefaults = true
         }
 
+        /**
+         * Decodes the string returned by an `evaluateScriptValue` wrapper script.
+         *
+         * Both `wvbridge-js-value-v2:<json>` and the legacy
+         * `wvbridge-js-value-v1:<base64(json)>` formats are accepted.
+         */
         internal fun String?.toJavaScriptBridgeValue(): JSValue {
             if (this == null) return Undefined
 
@@ -78,20 +86,10 @@ public sealed interface JSValue {
                 error("decode failed, result is $this")
             }
 
-            val header = value.substring(0, separator)
-            if (header != JavaScriptBridgeValueHeader) {
-                error("decode failed, result is $this")
-            }
-
-            val json = value.substring(separator + 1).base64Decode()
-            return JsonCodec.decodeFromString(json)
-        }
-
-        private fun String.unwrapWebViewStringLiteral(): String {
-            return runCatching {
-                JsonCodec.decodeFromString<String>(this)
-            }.getOrElse {
-                this
+            return when (value.substring(0, separator)) {
+                JavaScriptBridgeValueHeader -> JsonCodec.decodeFromString(value.substring(separator + 1))
+                JavaScriptBridgeValueHeaderV1 -> JsonCodec.decodeFromString(value.substring(separator + 1).base64Decode())
+                else -> error("decode failed, result is $this")
             }
         }
     }
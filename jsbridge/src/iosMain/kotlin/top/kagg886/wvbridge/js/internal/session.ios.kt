@@ -0,0 +1,28 @@
+package top.kagg886.wvbridge.js.internal
+
+import top.kagg886.wvbridge.bridge.JavaScriptBridge
+import kotlin.concurrent.AtomicReference
+import kotlin.experimental.ExperimentalNativeApi
+import kotlin.native.ref.WeakReference
+
+@OptIn(ExperimentalNativeApi::class)
+private class SessionEntry(bridge: JavaScriptBridge, val session: JavaScriptBridgeSession) {
+    val bridge = WeakReference(bridge)
+}
+
+private val sessions = AtomicReference<List<SessionEntry>>(emptyList())
+
+@OptIn(ExperimentalNativeApi::class)
+internal actual val JavaScriptBridge.session: JavaScriptBridgeSession
+    get() {
+        while (true) {
+            val current = sessions.value
+            current.firstOrNull { it.bridge.value === this }?.let { return it.session }
+
+            val entry = SessionEntry(this, JavaScriptBridgeSession())
+            val next = current.filter { it.bridge.value != null } + entry
+            if (sessions.compareAndSet(current, next)) {
+                return entry.session
+            }
+        }
+    }
@@ -0,0 +1,11 @@
+package top.kagg886.wvbridge.js.internal
+
+import top.kagg886.wvbridge.bridge.JavaScriptBridge
+import java.util.WeakHashMap
+
+private val sessions = WeakHashMap<JavaScriptBridge, JavaScriptBridgeSession>()
+
+internal actual val JavaScriptBridge.session: JavaScriptBridgeSession
+    get() = synchronized(sessions) {
+        sessions.getOrPut(this) { JavaScriptBridgeSession() }
+    }
@@ -0,0 +1,73 @@
+package top.kagg886.wvbridge.js.internal
+
+import kotlinx.serialization.json.JsonPrimitive
+import kotlinx.serialization.json.buildJsonObject
+import org.junit.Assume
+import top.kagg886.wvbridge.js.protocol.JSPacket.Companion.toJSPackets
+import top.kagg886.wvbridge.js.protocol.JSValue
+import java.io.File
+import java.util.concurrent.TimeUnit
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+/**
+ * Runs the injected runtime under Node.js with a fake native transport and decodes what it posts,
+ * so both the string and the structured (WebView2) wire forms are checked against the Kotlin side.
+ */
+class TrustedJsonTest {
+    @Test
+    fun trustedPrimitivesAndNullDecodeOnStringTransport() = assertTrustedValuesDecode(structured = false)
+
+    @Test
+    fun trustedPrimitivesAndNullDecodeOnStructuredTransport() = assertTrustedValuesDecode(structured = true)
+
+    private fun assertTrustedValuesDecode(structured: Boolean) {
+        val packets = postFromNode(
+            structured,
+            """wvbridge.postMessage("t", t(5), t("x"), t(null), t({ a: 1 }));""",
+        ).toJSPackets()
+
+        assertEquals(1, packets.size)
+        assertEquals("t", packets[0].type)
+        assertEquals(
+            listOf(
+                JSValue.ScriptObject("number", "5"),
+                JSValue.ScriptObject("string", "x"),
+                JSValue.Null,
+                JSValue.Serializable(buildJsonObject { put("a", JsonPrimitive(1)) }),
+            ),
+            packets[0].messages,
+        )
+    }
+
+    private fun postFromNode(structured: Boolean, statement: String): String {
+        val transport = if (structured) {
+            "window.chrome = { webview: { postMessage: (message) => posted.push(JSON.stringify(message)) } };"
+        } else {
+            "window.webkit = { messageHandlers: { wvbridge: { postMessage: (message) => posted.push(message) } } };"
+        }
+        val script = File.createTempFile("wvbridge-runtime", ".js").apply { deleteOnExit() }
+        script.writeText(
+            """
+            globalThis.window = globalThis;
+            const posted = [];
+            $transport
+            $WebViewBridgeExtInstallScript
+            const t = wvbridge.trustedJson;
+            $statement
+            process.stdout.write(posted[0]);
+            """.trimIndent()
+        )
+
+        val process = try {
+            ProcessBuilder("node", script.absolutePath).redirectErrorStream(true).start()
+        } catch (_: java.io.IOException) {
+            Assume.assumeTrue("node is not installed", false)
+            error("unreachable")
+        }
+        val output = process.inputStream.bufferedReader().readText()
+        process.waitFor(30, TimeUnit.SECONDS)
+        assertEquals(0, process.exitValue(), output)
+        return output
+    }
+}
@@ -22,6 +22,44 @@ void free_navigation_interceptor_result(char* value);
 void notify_can_go_back_change_to_jvm(jlong pointer, jboolean can_go_back);
 void notify_can_go_forward_change_to_jvm(jlong pointer, jboolean can_go_forward);
 void notify_webview_fatal_error_to_jvm(jlong pointer, wvbridge_native_string cause);
+// Reports that the WebView was reloaded in place after its web process died with cause. success is
+// whether the restored page finished loading; duration_millis runs from the termination until then.
+void notify_web_process_recovered_to_jvm(jlong pointer, wvbridge_native_string cause, jint attempt,
+                                         jlong duration_millis, jboolean success);
+// Reports that the content filter list identifier with the given source hash failed to compile.
+void notify_content_filter_failed_to_jvm(wvbridge_native_string identifier, wvbridge_native_string hash,
+                                         wvbridge_native_string reason);
+// Passes [data, data + size) to the JVM as a direct ByteBuffer without copying. The memory must
+// stay valid until the call returns. Returns whether a JVM handler accepted the message.
+jboolean notify_binary_message_to_jvm(jlong pointer, wvbridge_native_string channel, void* data, jlong size);
+
+// Response returned by a JVM scheme handler; exactly one of ref, path, and stream is set.
+// buffer_data aliases the direct ByteBuffer kept alive by the global ref, and stream is a global ref
+// to an InputStream. A consumer that keeps ref or stream clears the field and later releases it with
+// release_scheme_response_ref. Strings are malloc'd UTF-8.
+typedef struct wvbridge_scheme_response {
+    jint status;
+    char* mime_type;
+    void* buffer_data;
+    jlong buffer_size;
+    jobject ref;
+    char* path;
+    jobject stream;
+    jlong length;
+} wvbridge_scheme_response;
+
+// Asks the JVM handler registered for scheme to answer url. Returns JNI_FALSE when no handler
+// produced a response; *response is filled only on JNI_TRUE and must be passed to
+// free_scheme_response.
+jboolean notify_scheme_request_to_jvm(jlong pointer, wvbridge_native_string scheme, wvbridge_native_string url,
+                                      wvbridge_native_string method, wvbridge_scheme_response* response);
+void free_scheme_response(wvbridge_scheme_response* response);
+// Releases a global ref from wvbridge_scheme_response on any thread.
+void release_scheme_response_ref(jobject ref);
+// Reads up to size bytes from a response InputStream on any thread. Returns the byte count, 0 at
+// end of stream, or -1 when the stream throws.
+jlong read_scheme_response_stream(jobject stream, void* buffer, jlong size);
+void close_scheme_response_stream(jobject stream);
 
 #ifdef __cplusplus
 }
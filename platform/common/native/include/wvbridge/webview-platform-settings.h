@@ -1,6 +1,7 @@
 #pragma once
 
 #include <jni.h>
+#include <optional>
 #include <string>
 
 #if defined(_WIN32)
@@ -23,10 +24,58 @@ struct WvBridgeMacOSWebViewPlatformSetting {
 
 bool parse_webview_platform_settings(JNIEnv *env, jobject setting, WvBridgeMacOSWebViewPlatformSetting *out);
 #else
+enum class WvBridgeLinuxCacheModel {
+    DEFAULT,
+    DOCUMENT_VIEWER,
+    DOCUMENT_BROWSER,
+    WEB_BROWSER
+};
+
+enum class WvBridgeLinuxHardwareAcceleration {
+    DEFAULT,
+    ON_DEMAND,
+    ALWAYS,
+    NEVER
+};
+
+// Web process memory limits, see WebKitMemoryPressureSettings. Zero keeps
+// WebKitGTK's default for that value.
+struct WvBridgeLinuxMemoryPressureSetting {
+    unsigned int memory_limit_mb = 0;
+    double conservative_threshold = 0;
+    double strict_threshold = 0;
+    double kill_threshold = 0;
+    double poll_interval_seconds = 0;
+};
+
+// Empty optionals and DEFAULT values keep WebKitGTK's defaults.
+struct WvBridgeLinuxPerformanceSetting {
+    WvBridgeLinuxCacheModel cache_model = WvBridgeLinuxCacheModel::DEFAULT;
+    WvBridgeLinuxHardwareAcceleration hardware_acceleration = WvBridgeLinuxHardwareAcceleration::DEFAULT;
+    std::optional<bool> page_cache;
+    std::optional<bool> smooth_scrolling;
+    std::optional<bool> webgl;
+    std::optional<bool> media;
+    std::optional<bool> javascript_can_open_windows;
+    std::optional<bool> dns_prefetching;
+    std::optional<bool> process_swap_on_cross_site_navigation;
+    std::optional<WvBridgeLinuxMemoryPressureSetting> memory_pressure;
+};
+
+// Reload the WebView in place after its web process dies, at most
+// max_attempts times within period_seconds.
+struct WvBridgeLinuxCrashRecoverySetting {
+    unsigned int max_attempts = 0;
+    unsigned int period_seconds = 0;
+};
+
 struct WvBridgeLinuxWebViewPlatformSetting {
     std::string user_agent;
     std::string data_dir;
     std::string cache_dir;
+    bool non_persistent = false; // keep website data in memory; data_dir and cache_dir are unused
+    WvBridgeLinuxPerformanceSetting performance;
+    std::optional<WvBridgeLinuxCrashRecoverySetting> crash_recovery; // empty: close the WebView on a crash
 };
 
 bool parse_webview_platform_settings(JNIEnv *env, jobject setting, WvBridgeLinuxWebViewPlatformSetting *out);
@@ -0,0 +1,49 @@
+#include "listener_support.h"
+
+#include "wvbridge/java_runtime.h"
+#include "wvbridge/native_bridge.h"
+#include <wvbridge/logger.h>
+
+namespace {
+JvmStaticCallback g_binary_message_callback;
+}
+
+jboolean notify_binary_message_to_jvm(jlong pointer, wvbridge_native_string channel, void* data, jlong size) {
+    LOGGER_V("notify_binary_message_to_jvm: pointer=%lld data=%p size=%lld",
+             (long long)pointer, data, (long long)size);
+    int attached = 0;
+    JNIEnv* env = java_runtime_get_env(&attached);
+    if (env == nullptr) {
+        LOGGER_W("notify_binary_message_to_jvm: failed to get JNIEnv");
+        return JNI_FALSE;
+    }
+
+    jboolean handled = JNI_FALSE;
+    jclass callback_class = nullptr;
+    jmethodID method = acquire_native_bridge_callback(
+        env,
+        g_binary_message_callback,
+        "onBinaryMessageCallback",
+        "(JLjava/lang/String;Ljava/nio/ByteBuffer;)Z",
+        &callback_class
+    );
+    if (method != nullptr && callback_class != nullptr) {
+        jstring value = new_jvm_string(env, channel);
+        // The buffer aliases native memory owned by the caller and is only valid during the call.
+        static char empty = 0;
+        jobject buffer = env->NewDirectByteBuffer(data != nullptr ? data : &empty, data != nullptr ? size : 0);
+        if (buffer == nullptr) clear_jni_exception(env);
+
+        if (value != nullptr && buffer != nullptr) {
+            handled = env->CallStaticBooleanMethod(callback_class, method, pointer, value, buffer);
+            if (env->ExceptionCheck()) {
+                clear_jni_exception(env);
+                handled = JNI_FALSE;
+            }
+        }
+        if (buffer != nullptr) env->DeleteLocalRef(buffer);
+        if (value != nullptr) env->DeleteLocalRef(value);
+    }
+    java_runtime_detach_env(attached);
+    return handled;
+}
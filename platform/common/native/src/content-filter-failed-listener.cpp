@@ -0,0 +1,38 @@
+#include "listener_support.h"
+
+#include "wvbridge/java_runtime.h"
+#include "wvbridge/native_bridge.h"
+
+namespace {
+JvmStaticCallback g_content_filter_failed_callback;
+}
+
+void notify_content_filter_failed_to_jvm(
+    wvbridge_native_string identifier,
+    wvbridge_native_string hash,
+    wvbridge_native_string reason
+) {
+    int attached = 0;
+    JNIEnv* env = java_runtime_get_env(&attached);
+    if (env == nullptr) return;
+
+    jclass callback_class = nullptr;
+    jmethodID method = acquire_native_bridge_callback(
+        env,
+        g_content_filter_failed_callback,
+        "onContentFilterFailedCallback",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)V",
+        &callback_class
+    );
+    if (method != nullptr && callback_class != nullptr) {
+        jstring identifier_value = new_jvm_string(env, identifier);
+        jstring hash_value = new_jvm_string(env, hash);
+        jstring reason_value = reason != nullptr ? new_jvm_string(env, reason) : nullptr;
+        env->CallStaticVoidMethod(callback_class, method, identifier_value, hash_value, reason_value);
+        clear_jni_exception(env);
+        if (reason_value != nullptr) env->DeleteLocalRef(reason_value);
+        if (hash_value != nullptr) env->DeleteLocalRef(hash_value);
+        if (identifier_value != nullptr) env->DeleteLocalRef(identifier_value);
+    }
+    java_runtime_detach_env(attached);
+}
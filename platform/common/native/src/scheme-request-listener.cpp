@@ -0,0 +1,195 @@
+#include "listener_support.h"
+
+#include "wvbridge/java_runtime.h"
+#include "wvbridge/native_bridge.h"
+#include <wvbridge/logger.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+JvmStaticCallback g_scheme_request_callback;
+
+char* copy_jvm_string(JNIEnv* env, jstring value) {
+    if (value == nullptr) return nullptr;
+    const char* chars = env->GetStringUTFChars(value, nullptr);
+    if (chars == nullptr) {
+        clear_jni_exception(env);
+        return nullptr;
+    }
+    const size_t size = std::strlen(chars) + 1;
+    auto* result = static_cast<char*>(std::malloc(size));
+    if (result != nullptr) std::memcpy(result, chars, size);
+    env->ReleaseStringUTFChars(value, chars);
+    return result;
+}
+
+jobject get_object_field(JNIEnv* env, jobject object, jclass type, const char* name, const char* signature) {
+    jfieldID field = env->GetFieldID(type, name, signature);
+    if (field == nullptr) {
+        clear_jni_exception(env);
+        return nullptr;
+    }
+    return env->GetObjectField(object, field);
+}
+
+// Reads a NativeSchemeResponse into response. Returns false when the object is malformed.
+bool read_response(JNIEnv* env, jobject object, wvbridge_scheme_response* response) {
+    jclass type = env->GetObjectClass(object);
+    jfieldID status = env->GetFieldID(type, "status", "I");
+    jfieldID length = env->GetFieldID(type, "length", "J");
+    if (status == nullptr || length == nullptr) {
+        clear_jni_exception(env);
+        env->DeleteLocalRef(type);
+        return false;
+    }
+    response->status = env->GetIntField(object, status);
+    response->length = env->GetLongField(object, length);
+
+    auto mime_type = static_cast<jstring>(get_object_field(env, object, type, "mimeType", "Ljava/lang/String;"));
+    response->mime_type = copy_jvm_string(env, mime_type);
+    if (mime_type != nullptr) env->DeleteLocalRef(mime_type);
+
+    auto path = static_cast<jstring>(get_object_field(env, object, type, "path", "Ljava/lang/String;"));
+    response->path = copy_jvm_string(env, path);
+    if (path != nullptr) env->DeleteLocalRef(path);
+
+    jobject buffer = get_object_field(env, object, type, "buffer", "Ljava/nio/ByteBuffer;");
+    if (buffer != nullptr) {
+        // The JVM side only hands out direct buffers, so the body is served from their memory.
+        response->buffer_data = env->GetDirectBufferAddress(buffer);
+        response->buffer_size = env->GetDirectBufferCapacity(buffer);
+        if (response->buffer_data != nullptr) response->ref = env->NewGlobalRef(buffer);
+        env->DeleteLocalRef(buffer);
+    }
+
+    jobject stream = get_object_field(env, object, type, "stream", "Ljava/io/InputStream;");
+    if (stream != nullptr) {
+        response->stream = env->NewGlobalRef(stream);
+        env->DeleteLocalRef(stream);
+    }
+
+    env->DeleteLocalRef(type);
+    return response->ref != nullptr || response->path != nullptr || response->stream != nullptr;
+}
+}
+
+jboolean notify_scheme_request_to_jvm(jlong pointer, wvbridge_native_string scheme, wvbridge_native_string url,
+                                      wvbridge_native_string method, wvbridge_scheme_response* response) {
+    LOGGER_V("notify_scheme_request_to_jvm: pointer=%lld", (long long)pointer);
+    int attached = 0;
+    JNIEnv* env = java_runtime_get_env(&attached);
+    if (env == nullptr) {
+        LOGGER_W("notify_scheme_request_to_jvm: failed to get JNIEnv");
+        return JNI_FALSE;
+    }
+
+    jboolean handled = JNI_FALSE;
+    jclass callback_class = nullptr;
+    jmethodID callback = acquire_native_bridge_callback(
+        env,
+        g_scheme_request_callback,
+        "onSchemeRequestCallback",
+        "(JLjava/lang/String;Ljava/lang/String;Ljava/lang/String;)"
+        "Ltop/kagg886/wvbridge/internal/listener/NativeSchemeResponse;",
+        &callback_class
+    );
+    if (callback != nullptr && callback_class != nullptr) {
+        jstring scheme_value = new_jvm_string(env, scheme);
+        jstring url_value = new_jvm_string(env, url);
+        jstring method_value = new_jvm_string(env, method);
+
+        if (scheme_value != nullptr && url_value != nullptr && method_value != nullptr) {
+            jobject result = env->CallStaticObjectMethod(
+                callback_class, callback, pointer, scheme_value, url_value, method_value
+            );
+            if (env->ExceptionCheck()) {
+                clear_jni_exception(env);
+                result = nullptr;
+            }
+            if (result != nullptr) {
+                *response = wvbridge_scheme_response{};
+                if (read_response(env, result, response)) {
+                    handled = JNI_TRUE;
+                } else {
+                    LOGGER_W("notify_scheme_request_to_jvm: handler returned a response without a body");
+                    free_scheme_response(response);
+                }
+                env->DeleteLocalRef(result);
+            }
+        }
+        if (method_value != nullptr) env->DeleteLocalRef(method_value);
+        if (url_value != nullptr) env->DeleteLocalRef(url_value);
+        if (scheme_value != nullptr) env->DeleteLocalRef(scheme_value);
+    }
+    java_runtime_detach_env(attached);
+    return handled;
+}
+
+void free_scheme_response(wvbridge_scheme_response* response) {
+    if (response == nullptr) return;
+    std::free(response->mime_type);
+    std::free(response->path);
+    release_scheme_response_ref(response->ref);
+    release_scheme_response_ref(response->stream);
+    *response = wvbridge_scheme_response{};
+}
+
+void release_scheme_response_ref(jobject ref) {
+    if (ref == nullptr) return;
+    int attached = 0;
+    JNIEnv* env = java_runtime_get_env(&attached);
+    if (env == nullptr) {
+        LOGGER_W("release_scheme_response_ref: failed to get JNIEnv, leaking ref=%p", (void*)ref);
+        return;
+    }
+    env->DeleteGlobalRef(ref);
+    java_runtime_detach_env(attached);
+}
+
+jlong read_scheme_response_stream(jobject stream, void* buffer, jlong size) {
+    int attached = 0;
+    JNIEnv* env = java_runtime_get_env(&attached);
+    if (env == nullptr) {
+        LOGGER_W("read_scheme_response_stream: failed to get JNIEnv");
+        return -1;
+    }
+
+    jlong result = -1;
+    const jint chunk = static_cast<jint>(std::min<jlong>(size, 64 * 1024));
+    jclass type = env->GetObjectClass(stream);
+    jmethodID read = env->GetMethodID(type, "read", "([BII)I");
+    jbyteArray bytes = read != nullptr ? env->NewByteArray(chunk) : nullptr;
+    if (bytes != nullptr) {
+        const jint count = env->CallIntMethod(stream, read, bytes, 0, chunk);
+        if (env->ExceptionCheck()) {
+            clear_jni_exception(env);
+        } else if (count < 0) {
+            result = 0;
+        } else {
+            env->GetByteArrayRegion(bytes, 0, count, static_cast<jbyte*>(buffer));
+            result = count;
+        }
+        env->DeleteLocalRef(bytes);
+    } else {
+        clear_jni_exception(env);
+    }
+    env->DeleteLocalRef(type);
+    java_runtime_detach_env(attached);
+    return result;
+}
+
+void close_scheme_response_stream(jobject stream) {
+    if (stream == nullptr) return;
+    int attached = 0;
+    JNIEnv* env = java_runtime_get_env(&attached);
+    if (env == nullptr) return;
+
+    jclass type = env->GetObjectClass(stream);
+    jmethodID close = env->GetMethodID(type, "close", "()V");
+    if (close != nullptr) env->CallVoidMethod(stream, close);
+    clear_jni_exception(env);
+    env->DeleteLocalRef(type);
+    java_runtime_detach_env(attached);
+}
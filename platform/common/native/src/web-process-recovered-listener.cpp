@@ -0,0 +1,36 @@
+#include "listener_support.h"
+
+#include "wvbridge/java_runtime.h"
+#include "wvbridge/native_bridge.h"
+
+namespace {
+JvmStaticCallback g_web_process_recovered_callback;
+}
+
+void notify_web_process_recovered_to_jvm(
+    jlong pointer,
+    wvbridge_native_string cause,
+    jint attempt,
+    jlong duration_millis,
+    jboolean success
+) {
+    int attached = 0;
+    JNIEnv* env = java_runtime_get_env(&attached);
+    if (env == nullptr) return;
+
+    jclass callback_class = nullptr;
+    jmethodID method = acquire_native_bridge_callback(
+        env,
+        g_web_process_recovered_callback,
+        "onWebProcessRecoveredCallback",
+        "(JLjava/lang/String;IJZ)V",
+        &callback_class
+    );
+    if (method != nullptr && callback_class != nullptr) {
+        jstring value = cause != nullptr ? new_jvm_string(env, cause) : nullptr;
+        env->CallStaticVoidMethod(callback_class, method, pointer, value, attempt, duration_millis, success);
+        clear_jni_exception(env);
+        if (value != nullptr) env->DeleteLocalRef(value);
+    }
+    java_runtime_detach_env(attached);
+}
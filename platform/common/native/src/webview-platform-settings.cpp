@@ -42,7 +42,7 @@ std::string get_nullable_string_field(JNIEnv *env, jobject object, const char *n
     return result;
 }
 
-#if defined(__APPLE__)
+#if !defined(_WIN32)
 std::string get_enum_name(JNIEnv *env, jobject enum_value) {
     if (!enum_value) {
         return "";
@@ -68,6 +68,107 @@ std::string get_enum_name(JNIEnv *env, jobject enum_value) {
 }
 #endif
 
+#if !defined(_WIN32) && !defined(__APPLE__)
+std::string get_enum_field_name(JNIEnv *env, jobject object, const char *name, const char *signature) {
+    jclass cls = env->GetObjectClass(object);
+    jfieldID field = env->GetFieldID(cls, name, signature);
+    if (!field || env->ExceptionCheck()) {
+        return "";
+    }
+    return get_enum_name(env, env->GetObjectField(object, field));
+}
+
+jint get_int_field(JNIEnv *env, jobject object, const char *name) {
+    jclass cls = env->GetObjectClass(object);
+    jfieldID field = env->GetFieldID(cls, name, "I");
+    if (!field || env->ExceptionCheck()) {
+        return 0;
+    }
+    return env->GetIntField(object, field);
+}
+
+jdouble get_double_field(JNIEnv *env, jobject object, const char *name) {
+    jclass cls = env->GetObjectClass(object);
+    jfieldID field = env->GetFieldID(cls, name, "D");
+    if (!field || env->ExceptionCheck()) {
+        return 0;
+    }
+    return env->GetDoubleField(object, field);
+}
+
+std::optional<WvBridgeLinuxMemoryPressureSetting> get_memory_pressure_field(JNIEnv *env, jobject object) {
+    jclass cls = env->GetObjectClass(object);
+    jfieldID field = env->GetFieldID(
+        cls, "memoryPressure", "Ltop/kagg886/wvbridge/config/internal/NativeLinuxMemoryPressureSetting;"
+    );
+    if (!field || env->ExceptionCheck()) {
+        return std::nullopt;
+    }
+    jobject value = env->GetObjectField(object, field);
+    if (!value) {
+        return std::nullopt;
+    }
+
+    WvBridgeLinuxMemoryPressureSetting result;
+    const jint memory_limit_mb = get_int_field(env, value, "memoryLimitMB");
+    result.memory_limit_mb = memory_limit_mb > 0 ? static_cast<unsigned int>(memory_limit_mb) : 0;
+    result.conservative_threshold = get_double_field(env, value, "conservativeThreshold");
+    result.strict_threshold = get_double_field(env, value, "strictThreshold");
+    result.kill_threshold = get_double_field(env, value, "killThreshold");
+    result.poll_interval_seconds = get_double_field(env, value, "pollIntervalSeconds");
+    if (env->ExceptionCheck()) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+std::optional<WvBridgeLinuxCrashRecoverySetting> get_crash_recovery_field(JNIEnv *env, jobject object) {
+    jclass cls = env->GetObjectClass(object);
+    jfieldID field = env->GetFieldID(
+        cls, "crashRecovery", "Ltop/kagg886/wvbridge/config/internal/NativeLinuxCrashRecoverySetting;"
+    );
+    if (!field || env->ExceptionCheck()) {
+        return std::nullopt;
+    }
+    jobject value = env->GetObjectField(object, field);
+    if (!value) {
+        return std::nullopt;
+    }
+
+    const jint max_attempts = get_int_field(env, value, "maxAttempts");
+    const jint period_seconds = get_int_field(env, value, "periodSeconds");
+    if (env->ExceptionCheck() || max_attempts <= 0 || period_seconds <= 0) {
+        return std::nullopt;
+    }
+    WvBridgeLinuxCrashRecoverySetting result;
+    result.max_attempts = static_cast<unsigned int>(max_attempts);
+    result.period_seconds = static_cast<unsigned int>(period_seconds);
+    return result;
+}
+
+std::optional<bool> get_nullable_boolean_field(JNIEnv *env, jobject object, const char *name) {
+    jclass cls = env->GetObjectClass(object);
+    jfieldID field = env->GetFieldID(cls, name, "Ljava/lang/Boolean;");
+    if (!field || env->ExceptionCheck()) {
+        return std::nullopt;
+    }
+
+    jobject value = env->GetObjectField(object, field);
+    if (!value) {
+        return std::nullopt;
+    }
+    jmethodID boolean_value = env->GetMethodID(env->GetObjectClass(value), "booleanValue", "()Z");
+    if (!boolean_value || env->ExceptionCheck()) {
+        return std::nullopt;
+    }
+    const jboolean result = env->CallBooleanMethod(value, boolean_value);
+    if (env->ExceptionCheck()) {
+        return std::nullopt;
+    }
+    return result == JNI_TRUE;
+}
+#endif
+
 }
 
 #if defined(_WIN32)
@@ -110,6 +211,35 @@ bool parse_webview_platform_settings(JNIEnv *env, jobject setting, WvBridgeLinux
     out->user_agent = get_nullable_string_field(env, setting, "userAgent");
     out->data_dir = get_nullable_string_field(env, setting, "dataDir");
     out->cache_dir = get_nullable_string_field(env, setting, "cacheDir");
+    out->non_persistent = get_enum_field_name(
+        env, setting, "websiteDataStore", "Ltop/kagg886/wvbridge/config/internal/NativeLinuxWebsiteDataStore;"
+    ) == "NON_PERSISTENT";
+
+    auto &performance = out->performance;
+    const std::string cache_model = get_enum_field_name(
+        env, setting, "cacheModel", "Ltop/kagg886/wvbridge/config/internal/NativeLinuxCacheModel;"
+    );
+    performance.cache_model = cache_model == "DOCUMENT_VIEWER" ? WvBridgeLinuxCacheModel::DOCUMENT_VIEWER
+        : cache_model == "DOCUMENT_BROWSER" ? WvBridgeLinuxCacheModel::DOCUMENT_BROWSER
+        : cache_model == "WEB_BROWSER" ? WvBridgeLinuxCacheModel::WEB_BROWSER
+        : WvBridgeLinuxCacheModel::DEFAULT;
+    const std::string hardware_acceleration = get_enum_field_name(
+        env, setting, "hardwareAcceleration", "Ltop/kagg886/wvbridge/config/internal/NativeLinuxHardwareAcceleration;"
+    );
+    performance.hardware_acceleration = hardware_acceleration == "ON_DEMAND" ? WvBridgeLinuxHardwareAcceleration::ON_DEMAND
+        : hardware_acceleration == "ALWAYS" ? WvBridgeLinuxHardwareAcceleration::ALWAYS
+        : hardware_acceleration == "NEVER" ? WvBridgeLinuxHardwareAcceleration::NEVER
+        : WvBridgeLinuxHardwareAcceleration::DEFAULT;
+    performance.page_cache = get_nullable_boolean_field(env, setting, "pageCache");
+    performance.smooth_scrolling = get_nullable_boolean_field(env, setting, "smoothScrolling");
+    performance.webgl = get_nullable_boolean_field(env, setting, "webGL");
+    performance.media = get_nullable_boolean_field(env, setting, "media");
+    performance.javascript_can_open_windows = get_nullable_boolean_field(env, setting, "javaScriptCanOpenWindows");
+    performance.dns_prefetching = get_nullable_boolean_field(env, setting, "dnsPrefetching");
+    performance.process_swap_on_cross_site_navigation =
+        get_nullable_boolean_field(env, setting, "processSwapOnCrossSiteNavigation");
+    performance.memory_pressure = get_memory_pressure_field(env, setting);
+    out->crash_recovery = get_crash_recovery_field(env, setting);
     return !env->ExceptionCheck();
 }
 #endif
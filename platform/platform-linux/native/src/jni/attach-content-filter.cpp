@@ -0,0 +1,52 @@
+#include "javascript-helpers.h"
+
+#include "content_filter.h"
+
+API_EXPORT(void, attachContentFilter, jlong handle, jstring identifier, jstring hash, jstring rules) {
+    LOGGER_I("attachContentFilter: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return;
+    if (identifier == nullptr || hash == nullptr || rules == nullptr) {
+        LOGGER_E("attachContentFilter: null argument, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "content filter argument is null");
+        return;
+    }
+
+    const std::string name = jstring_to_string(env, identifier);
+    if (env->ExceptionCheck()) return;
+    const std::string digest = jstring_to_string(env, hash);
+    if (env->ExceptionCheck()) return;
+
+    // The rule list is only transcoded when it is not already loaded for this store.
+    std::shared_ptr<const std::string> source;
+    bool webviewAvailable = false;
+    auto result = wvbridge::ContentFilterResult::NEEDS_RULES;
+    for (int attempt = 0; attempt < 2 && result == wvbridge::ContentFilterResult::NEEDS_RULES; ++attempt) {
+        if (attempt > 0) {
+            source = std::make_shared<const std::string>(jstring_to_string(env, rules));
+            if (env->ExceptionCheck()) return;
+        }
+        wvbridge::gtk_run_on_thread_sync([ctx, &name, &digest, &source, &webviewAvailable, &result] {
+            if (!ctx->webview) {
+                LOGGER_V("attachContentFilter: ctx->webview is null in GTK thread");
+                webviewAvailable = false;
+                return;
+            }
+            webviewAvailable = true;
+            result = wvbridge::content_filter_attach(ctx->webview, ctx->content_filter_dir, name, digest, source);
+        });
+        if (!webviewAvailable) break;
+    }
+
+    if (!webviewAvailable) {
+        LOGGER_E("attachContentFilter: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+    } else if (result == wvbridge::ContentFilterResult::UNSUPPORTED) {
+        throw_jni_exception(env, "java/lang/UnsupportedOperationException",
+                            "content filters require WebKitGTK 2.26 or newer");
+    } else if (result == wvbridge::ContentFilterResult::NO_STORE) {
+        throw_jni_exception(env, "java/lang/IllegalStateException",
+                            "content filters need a website data directory; set dataDir for this WebView");
+    }
+}
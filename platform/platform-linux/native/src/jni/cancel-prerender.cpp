@@ -0,0 +1,14 @@
+#include "javascript-helpers.h"
+
+#include "prerender.h"
+
+API_EXPORT(void, cancelPrerender, jlong handle, jlong id) {
+    LOGGER_I("cancelPrerender: handle=%lld id=%lld", (long long)handle, (long long)id);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return;
+
+    wvbridge::gtk_run_on_thread_sync([ctx, id] {
+        wvbridge::prerender_cancel(ctx, id);
+    });
+}
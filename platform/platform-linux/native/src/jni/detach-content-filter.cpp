@@ -0,0 +1,33 @@
+#include "javascript-helpers.h"
+
+#include "content_filter.h"
+
+API_EXPORT(void, detachContentFilter, jlong handle, jstring identifier) {
+    LOGGER_I("detachContentFilter: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return;
+    if (identifier == nullptr) {
+        LOGGER_E("detachContentFilter: null identifier, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "identifier is null");
+        return;
+    }
+
+    const std::string name = jstring_to_string(env, identifier);
+    if (env->ExceptionCheck()) return;
+
+    bool webviewAvailable = false;
+    wvbridge::gtk_run_on_thread_sync([ctx, &name, &webviewAvailable] {
+        if (!ctx->webview) {
+            LOGGER_V("detachContentFilter: ctx->webview is null in GTK thread");
+            return;
+        }
+        webviewAvailable = true;
+        wvbridge::content_filter_detach(ctx->webview, name);
+    });
+
+    if (!webviewAvailable) {
+        LOGGER_E("detachContentFilter: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+    }
+}
@@ -1,24 +1,149 @@
 #include "javascript-helpers.h"
 
+#include <cstdio>
 #include <future>
+#include <memory>
 
-API_EXPORT(jstring, evaluateScript, jlong handle, jstring script) {
-    LOGGER_I("evaluateScript: handle=%lld", (long long)handle);
+namespace {
 
-    auto *ctx = require_context(env, handle);
-    if (!ctx) return nullptr;
-    if (script == nullptr) {
-        LOGGER_E("evaluateScript: null script, throwing NPE");
-        throw_jni_exception(env, "java/lang/NullPointerException", "script is null");
-        return nullptr;
+void append_json_string(std::string &out, const char *value) {
+    out.push_back('"');
+    for (const unsigned char *c = reinterpret_cast<const unsigned char *>(value ? value : ""); *c; ++c) {
+        switch (*c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (*c < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                    out += escaped;
+                } else {
+                    out.push_back(static_cast<char>(*c));
+                }
+        }
     }
+    out.push_back('"');
+}
 
-    const std::string source = jstring_to_string(env, script);
-    if (env->ExceptionCheck()) {
-        LOGGER_W("evaluateScript: JVM exception after jstring_to_string, aborting");
-        return nullptr;
+// Structured evaluations run the script as a function body inside this wrapper, so the result is
+// encoded in the page. The value WebKit hands back to the UI process is a structured clone, which
+// has already run getters, dropped prototypes and rejected functions, so it cannot be classified
+// faithfully here. The jsbridge runtime's encoder is used when the page has it, which also honours
+// trustedJson; otherwise a copy of its strict JSON walk (encodeStrictJson in jsbridge's template.kt)
+// is used. Keep the two in sync.
+constexpr const char *STRUCTURED_PREFIX = R"JS((() => {
+  const toObjectString = (value) => {
+    try {
+      return String(value);
+    } catch (_) {
+      return Object.prototype.toString.call(value);
+    }
+  };
+  const toScriptObjectJson = (value) => {
+    const type = typeof value;
+    return JSON.stringify({
+      kind: "scriptObject",
+      type: value === null || (type !== "object" && type !== "function") ? type : Object.prototype.toString.call(value),
+      value: toObjectString(value)
+    });
+  };
+  const encodeStrictJson = (value, seen) => {
+    if (value === null) return "null";
+    switch (typeof value) {
+      case "string": return JSON.stringify(value);
+      case "boolean": return value ? "true" : "false";
+      case "number": return Number.isFinite(value) && !Object.is(value, -0) ? String(value) : undefined;
+      case "object": break;
+      default: return undefined;
+    }
+    if (seen.has(value)) return undefined;
+    seen.add(value);
+    const isArray = Array.isArray(value);
+    if (!isArray) {
+      const proto = Object.getPrototypeOf(value);
+      if (proto !== Object.prototype && proto !== null) return undefined;
+    }
+    const descriptors = Object.getOwnPropertyDescriptors(value);
+    const parts = [];
+    for (const key of Reflect.ownKeys(descriptors)) {
+      if (typeof key === "symbol") return undefined;
+      if (isArray && key === "length") continue;
+      const descriptor = descriptors[key];
+      if (!descriptor.enumerable || !("value" in descriptor)) return undefined;
+      if (isArray && key !== String(parts.length)) return undefined;
+      const json = encodeStrictJson(descriptor.value, seen);
+      if (json === undefined) return undefined;
+      parts.push(isArray ? json : JSON.stringify(key) + ":" + json);
+    }
+    if (isArray && parts.length !== value.length) return undefined;
+    return isArray ? "[" + parts.join(",") + "]" : "{" + parts.join(",") + "}";
+  };
+  const runtime = globalThis.__wvbridge__;
+  const toJSValueJson = runtime !== undefined ? runtime.toJSValueJson : (value) => {
+    if (value === undefined) return '{"kind":"undefined"}';
+    if (value === null) return '{"kind":"null"}';
+    if (typeof value !== "object") return toScriptObjectJson(value);
+    let json;
+    try {
+      json = encodeStrictJson(value, new WeakSet());
+    } catch (_) {
+      json = undefined;
     }
-    LOGGER_V("evaluateScript: source len=%zu", source.size());
+    return json === undefined ? toScriptObjectJson(value) : '{"kind":"serializable","value":' + json + "}";
+  };
+  try {
+    return toJSValueJson(function () {
+)JS";
+
+constexpr const char *STRUCTURED_SUFFIX = R"JS(
+    }.apply(globalThis));
+  } catch (error) {
+    return JSON.stringify({
+      kind: "error",
+      stacktrace: error && typeof error.stack === "string" ? error.stack : toObjectString(error)
+    });
+  }
+})())JS";
+
+std::shared_ptr<const std::string> wrap_structured(const std::string &body) {
+    std::string source = STRUCTURED_PREFIX;
+    source += body;
+    source += STRUCTURED_SUFFIX;
+    return std::make_shared<const std::string>(std::move(source));
+}
+
+// The wrapper always returns the JSON text built in the page.
+std::string to_structured_result(JSCValue *value) {
+    if (!value || !jsc_value_is_string(value)) return R"({"kind":"undefined"})";
+
+    gchar *json = jsc_value_to_string(value);
+    std::string out = json ? json : R"({"kind":"undefined"})";
+    if (json) g_free(json);
+    return out;
+}
+
+std::string legacy_result(JSCValue *value, bool *has_value) {
+    *has_value = true;
+    if (!value || jsc_value_is_undefined(value)) {
+        *has_value = false;
+        return "";
+    }
+    if (jsc_value_is_null(value)) return "null";
+    if (jsc_value_is_boolean(value)) return jsc_value_to_boolean(value) ? "true" : "false";
+
+    gchar *stringValue = jsc_value_to_string(value);
+    std::string output = stringValue ? stringValue : "";
+    if (stringValue) g_free(stringValue);
+    return output;
+}
+
+// source is shared with the GTK closure rather than copied, so interned scripts cross threads
+// without duplicating their text.
+jstring evaluate_script(JNIEnv *env, WebViewContext *ctx, std::shared_ptr<const std::string> source, bool structured) {
+    LOGGER_V("evaluateScript: source len=%zu structured=%d", source->size(), structured ? 1 : 0);
 
     struct Result {
         bool ok = false;
@@ -27,11 +152,16 @@ API_EXPORT(jstring, evaluateScript, jlong handle, jstring script) {
         std::string error;
     };
 
+    struct CallbackData {
+        std::shared_ptr<std::promise<Result>> completion;
+        bool structured = false;
+    };
+
     auto completion = std::make_shared<std::promise<Result>>();
     auto future = completion->get_future();
 
     LOGGER_V("evaluateScript: dispatching to GTK thread");
-    wvbridge::gtk_run_on_thread_sync([ctx, source, completion] {
+    wvbridge::gtk_run_on_thread_sync([ctx, source, completion, structured] {
         if (!ctx->webview) {
             LOGGER_V("evaluateScript: ctx->webview is null in GTK thread");
             completion->set_value(Result{false, false, "", "webview is not available"});
@@ -39,18 +169,17 @@ API_EXPORT(jstring, evaluateScript, jlong handle, jstring script) {
         }
 
         LOGGER_V("evaluateScript: calling webkit_web_view_evaluate_javascript");
-        auto *completionPtr = new std::shared_ptr<std::promise<Result>>(completion);
         webkit_web_view_evaluate_javascript(
             ctx->webview,
-            source.c_str(),
-            -1,
+            source->c_str(),
+            static_cast<gssize>(source->size()),
             nullptr,
             nullptr,
             nullptr,
             [](GObject *object, GAsyncResult *asyncResult, gpointer userData) {
-                auto completionHolder = static_cast<std::shared_ptr<std::promise<Result>> *>(userData);
-                std::shared_ptr<std::promise<Result>> completion = *completionHolder;
-                delete completionHolder;
+                std::unique_ptr<CallbackData> data(static_cast<CallbackData *>(userData));
+                const std::shared_ptr<std::promise<Result>> completion = data->completion;
+                const bool structured = data->structured;
 
                 GError *error = nullptr;
                 JSCValue *value = webkit_web_view_evaluate_javascript_finish(
@@ -61,49 +190,29 @@ API_EXPORT(jstring, evaluateScript, jlong handle, jstring script) {
 
                 if (error) {
                     std::string message = error->message ? error->message : "WebKitGTK JavaScript evaluation failed";
+                    const bool script_failed = error->domain == WEBKIT_JAVASCRIPT_ERROR &&
+                                               error->code == WEBKIT_JAVASCRIPT_ERROR_SCRIPT_FAILED;
                     LOGGER_V("evaluateScript: async callback error=%s", message.c_str());
                     g_error_free(error);
+                    if (structured && script_failed) {
+                        std::string output = R"({"kind":"error","stacktrace":)";
+                        append_json_string(output, message.c_str());
+                        output.push_back('}');
+                        completion->set_value(Result{true, true, output, ""});
+                        return;
+                    }
                     completion->set_value(Result{false, false, "", message});
                     return;
                 }
 
-                if (!value) {
-                    LOGGER_V("evaluateScript: async callback no value");
-                    completion->set_value(Result{true, false, "", ""});
-                    return;
-                }
-
-                if (!value || jsc_value_is_undefined(value)) {
-                    LOGGER_V("evaluateScript: async callback value is undefined");
-                    g_object_unref(value);
-                    completion->set_value(Result{true, false, "", ""});
-                    return;
-                }
-                if (jsc_value_is_null(value)) {
-                    LOGGER_V("evaluateScript: async callback value is null");
-                    g_object_unref(value);
-                    completion->set_value(Result{true, true, "null", ""});
-                    return;
-                }
-                if (jsc_value_is_boolean(value)) {
-                    const bool booleanValue = jsc_value_to_boolean(value);
-                    std::string output = booleanValue ? "true" : "false";
-                    g_object_unref(value);
-
-                    LOGGER_V("evaluateScript: async callback boolean result=%s", output.c_str());
-                    completion->set_value(Result{true, true, output, ""});
-                    return;
-                }
-
-                gchar *stringValue = value ? jsc_value_to_string(value) : nullptr;
-                std::string output = stringValue ? stringValue : "";
-                if (stringValue) g_free(stringValue);
-                g_object_unref(value);
+                Result result{true, true, "", ""};
+                result.value = structured ? to_structured_result(value) : legacy_result(value, &result.has_value);
+                if (value) g_object_unref(value);
 
-                LOGGER_V("evaluateScript: async callback result=%s", output.c_str());
-                completion->set_value(Result{true, true, output, ""});
+                LOGGER_V("evaluateScript: async callback result len=%zu", result.value.size());
+                completion->set_value(result);
             },
-            completionPtr
+            new CallbackData{completion, structured}
         );
     });
 
@@ -120,3 +229,50 @@ API_EXPORT(jstring, evaluateScript, jlong handle, jstring script) {
     LOGGER_V("evaluateScript: returning value len=%zu", result.value.size());
     return env->NewStringUTF(result.value.c_str());
 }
+
+std::shared_ptr<const std::string> require_script(JNIEnv *env, jstring script) {
+    if (script == nullptr) {
+        LOGGER_E("evaluateScript: null script, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "script is null");
+        return nullptr;
+    }
+
+    auto source = std::make_shared<const std::string>(jstring_to_string(env, script));
+    if (env->ExceptionCheck()) {
+        LOGGER_W("evaluateScript: JVM exception after jstring_to_string, aborting");
+        return nullptr;
+    }
+    return source;
+}
+
+} // namespace
+
+API_EXPORT(jstring, evaluateScript, jlong handle, jstring script) {
+    LOGGER_I("evaluateScript: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return nullptr;
+    auto source = require_script(env, script);
+    if (!source) return nullptr;
+    return evaluate_script(env, ctx, std::move(source), false);
+}
+
+API_EXPORT(jstring, evaluateScriptStructured, jlong handle, jstring script) {
+    LOGGER_I("evaluateScriptStructured: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return nullptr;
+    auto source = require_script(env, script);
+    if (!source) return nullptr;
+    return evaluate_script(env, ctx, wrap_structured(*source), true);
+}
+
+API_EXPORT(jstring, evaluateInternedScript, jlong handle, jstring key, jstring script) {
+    LOGGER_I("evaluateInternedScript: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return nullptr;
+    auto entry = resolve_interned_script(env, key, script);
+    if (!entry) return nullptr;
+    return evaluate_script(env, ctx, std::shared_ptr<const std::string>(entry, &entry->source), false);
+}
@@ -8,6 +8,9 @@
 #include <wvbridge/logger.h>
 #include <wvbridge/webview-platform-settings.h>
 
+#include "content_filter.h"
+#include "data_scheme.h"
+#include "web_context_pool.h"
 #include "webview_lifecycle.h"
 #include "x11_embed.h"
 
@@ -106,42 +109,124 @@ void set_failure(bool* ok, std::string* error, const std::string& message) {
     LOGGER_E("init.gtk: failure=%s", message.c_str());
 }
 
+WebKitCacheModel to_webkit_cache_model(WvBridgeLinuxCacheModel model) {
+    switch (model) {
+        case WvBridgeLinuxCacheModel::DOCUMENT_VIEWER:
+            return WEBKIT_CACHE_MODEL_DOCUMENT_VIEWER;
+        case WvBridgeLinuxCacheModel::DOCUMENT_BROWSER:
+            return WEBKIT_CACHE_MODEL_DOCUMENT_BROWSER;
+        default:
+            return WEBKIT_CACHE_MODEL_WEB_BROWSER;
+    }
+}
+
+WebKitHardwareAccelerationPolicy to_webkit_hardware_acceleration(WvBridgeLinuxHardwareAcceleration policy) {
+    switch (policy) {
+        case WvBridgeLinuxHardwareAcceleration::ALWAYS:
+            return WEBKIT_HARDWARE_ACCELERATION_POLICY_ALWAYS;
+        case WvBridgeLinuxHardwareAcceleration::NEVER:
+            return WEBKIT_HARDWARE_ACCELERATION_POLICY_NEVER;
+        default:
+            return WEBKIT_HARDWARE_ACCELERATION_POLICY_ON_DEMAND;
+    }
+}
+
+void apply_performance_setting(WebKitWebView* webview, const WvBridgeLinuxPerformanceSetting& performance) {
+    WebKitSettings* web_settings = webkit_web_view_get_settings(webview);
+    LOGGER_V("init.gtk: applying performance settings settings=%p cache_model=%d hardware_acceleration=%d",
+             web_settings, static_cast<int>(performance.cache_model),
+             static_cast<int>(performance.hardware_acceleration));
+
+    if (performance.cache_model != WvBridgeLinuxCacheModel::DEFAULT) {
+        // The cache model belongs to the web context, so WebViews sharing it share the model.
+        webkit_web_context_set_cache_model(webkit_web_view_get_context(webview),
+                                           to_webkit_cache_model(performance.cache_model));
+    }
+    if (!web_settings) return;
+
+    if (performance.hardware_acceleration != WvBridgeLinuxHardwareAcceleration::DEFAULT) {
+        webkit_settings_set_hardware_acceleration_policy(
+            web_settings, to_webkit_hardware_acceleration(performance.hardware_acceleration)
+        );
+    }
+    if (performance.page_cache) {
+        webkit_settings_set_enable_page_cache(web_settings, *performance.page_cache);
+    }
+    if (performance.smooth_scrolling) {
+        webkit_settings_set_enable_smooth_scrolling(web_settings, *performance.smooth_scrolling);
+    }
+    if (performance.webgl) {
+        webkit_settings_set_enable_webgl(web_settings, *performance.webgl);
+    }
+#if WEBKIT_CHECK_VERSION(2, 26, 0)
+    if (performance.media) {
+        webkit_settings_set_enable_media(web_settings, *performance.media);
+    }
+#endif
+    if (performance.javascript_can_open_windows) {
+        webkit_settings_set_javascript_can_open_windows_automatically(
+            web_settings, *performance.javascript_can_open_windows
+        );
+    }
+    if (performance.dns_prefetching) {
+        // Deprecated and ignored by newer WebKitGTK releases, which decide on their own.
+        G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+        webkit_settings_set_enable_dns_prefetching(web_settings, *performance.dns_prefetching);
+        G_GNUC_END_IGNORE_DEPRECATIONS
+    }
+}
+
+WebKitWebsiteDataManager* create_website_data_manager(const WvBridgeLinuxWebViewPlatformSetting& setting) {
+    if (!setting.data_dir.empty() && !setting.cache_dir.empty()) {
+        return webkit_website_data_manager_new(
+            "base-data-directory", setting.data_dir.c_str(),
+            "base-cache-directory", setting.cache_dir.c_str(),
+            nullptr
+        );
+    }
+    if (!setting.data_dir.empty()) {
+        return webkit_website_data_manager_new("base-data-directory", setting.data_dir.c_str(), nullptr);
+    }
+    if (!setting.cache_dir.empty()) {
+        return webkit_website_data_manager_new("base-cache-directory", setting.cache_dir.c_str(), nullptr);
+    }
+    return webkit_website_data_manager_new(nullptr);
+}
+
 WebKitWebView* create_webview(
     const WvBridgeLinuxWebViewPlatformSetting& setting,
     std::string* error
 ) {
-    LOGGER_D("init.gtk: phase=create-webview data_dir_set=%d cache_dir_set=%d user_agent_set=%d",
+    const auto& performance = setting.performance;
+    LOGGER_D("init.gtk: phase=create-webview non_persistent=%d data_dir_set=%d cache_dir_set=%d user_agent_set=%d process_swap=%d memory_pressure=%d",
+             setting.non_persistent ? 1 : 0,
              setting.data_dir.empty() ? 0 : 1,
              setting.cache_dir.empty() ? 0 : 1,
-             setting.user_agent.empty() ? 0 : 1);
+             setting.user_agent.empty() ? 0 : 1,
+             performance.process_swap_on_cross_site_navigation
+                 ? (*performance.process_swap_on_cross_site_navigation ? 1 : 0) : -1,
+             performance.memory_pressure ? 1 : 0);
     WebKitWebView* webview = nullptr;
-    if (setting.data_dir.empty() && setting.cache_dir.empty()) {
+    if (setting.non_persistent) {
+        WebKitWebContext* web_context = wvbridge::web_context_pool_acquire_ephemeral(performance);
+        if (web_context) {
+            webview = WEBKIT_WEB_VIEW(webkit_web_view_new_with_context(web_context));
+            g_object_unref(web_context);
+        }
+        LOGGER_V("init.gtk: ephemeral WebView created context=%p webview=%p", web_context, webview);
+    } else if (setting.data_dir.empty() && setting.cache_dir.empty() &&
+               !wvbridge::web_context_needs_construct_options(performance)) {
         webview = WEBKIT_WEB_VIEW(webkit_web_view_new());
         LOGGER_V("init.gtk: default WebView created webview=%p", webview);
     } else {
-        WebKitWebsiteDataManager* manager = nullptr;
-        if (!setting.data_dir.empty() && !setting.cache_dir.empty()) {
-            manager = webkit_website_data_manager_new(
-                "base-data-directory", setting.data_dir.c_str(),
-                "base-cache-directory", setting.cache_dir.c_str(),
-                nullptr
-            );
-        } else if (!setting.data_dir.empty()) {
-            manager = webkit_website_data_manager_new(
-                "base-data-directory", setting.data_dir.c_str(), nullptr
-            );
-        } else {
-            manager = webkit_website_data_manager_new(
-                "base-cache-directory", setting.cache_dir.c_str(), nullptr
-            );
-        }
+        WebKitWebsiteDataManager* manager = create_website_data_manager(setting);
         LOGGER_V("init.gtk: website data manager created manager=%p", manager);
         if (!manager) {
             if (error) *error = "Unable to create WebKitWebsiteDataManager";
             LOGGER_E("init.gtk: website data manager creation returned null");
             return nullptr;
         }
-        WebKitWebContext* web_context = webkit_web_context_new_with_website_data_manager(manager);
+        WebKitWebContext* web_context = wvbridge::web_context_new(manager, performance);
         LOGGER_V("init.gtk: WebKit context created context=%p manager=%p", web_context, manager);
         if (web_context) {
             webview = WEBKIT_WEB_VIEW(webkit_web_view_new_with_context(web_context));
@@ -167,48 +252,10 @@ WebKitWebView* create_webview(
                  web_settings, setting.user_agent.size());
         if (web_settings) webkit_settings_set_user_agent(web_settings, setting.user_agent.c_str());
     }
+    apply_performance_setting(webview, performance);
     return webview;
 }
 
-void wvbridge_script_message_received(
-    WebKitUserContentManager*,
-    WebKitJavascriptResult* result,
-    gpointer user_data
-) {
-    auto* ctx = static_cast<WebViewContext*>(user_data);
-    LOGGER_V("webmessage.receive: entry ctx=%p result=%p closing=%d",
-             ctx, result,
-             ctx && ctx->closing.load(std::memory_order_acquire) ? 1 : 0);
-    if (!ctx || !result) {
-        LOGGER_W("webmessage.receive: missing context or result ctx=%p result=%p", ctx, result);
-        return;
-    }
-    if (ctx->closing.load(std::memory_order_acquire)) {
-        LOGGER_V("webmessage.receive: context closing; callback suppressed ctx=%p", ctx);
-        return;
-    }
-
-    JSCValue* value = webkit_javascript_result_get_js_value(result);
-    if (!value || jsc_value_is_undefined(value) || jsc_value_is_null(value)) {
-        LOGGER_D("webmessage.receive: phase=dispatch-empty ctx=%p value=%p", ctx, value);
-        wvbridge::dispatch_web_message_to_java(
-            ctx->web_message_handlers_mutex, ctx->web_message_handlers, ""
-        );
-        LOGGER_V("webmessage.receive: empty message dispatched ctx=%p", ctx);
-        return;
-    }
-
-    gchar* string_value = jsc_value_to_string(value);
-    std::string message = string_value ? string_value : "";
-    LOGGER_D("webmessage.receive: phase=dispatch ctx=%p bytes=%zu preview=%.100s",
-             ctx, message.size(), message.c_str());
-    if (string_value) g_free(string_value);
-    wvbridge::dispatch_web_message_to_java(
-        ctx->web_message_handlers_mutex, ctx->web_message_handlers, message.c_str()
-    );
-    LOGGER_V("webmessage.receive: dispatch complete ctx=%p bytes=%zu", ctx, message.size());
-}
-
 } // namespace
 
 API_EXPORT(jlong, initAndAttach, jobject platformSetting) {
@@ -237,6 +284,7 @@ API_EXPORT(jlong, initAndAttach, jobject platformSetting) {
 
     std::string error;
     auto ctx = std::make_unique<WebViewContext>();
+    ctx->crash_recovery = setting.crash_recovery;
     const jlong handle = reinterpret_cast<jlong>(ctx.get());
     bool created = true;
     LOGGER_D("init: phase=create-on-gtk-thread ctx=%p handle=%lld",
@@ -272,6 +320,7 @@ API_EXPORT(jlong, initAndAttach, jobject platformSetting) {
                 wvbridge::destroy_webview_on_gtk_thread(ctx.get());
                 return;
             }
+            ctx->content_filter_dir = wvbridge::content_filter_store_dir(ctx->webview, setting.data_dir);
             gtk_widget_set_can_focus(GTK_WIDGET(ctx->webview), TRUE);
             gtk_widget_set_hexpand(GTK_WIDGET(ctx->webview), TRUE);
             gtk_widget_set_vexpand(GTK_WIDGET(ctx->webview), TRUE);
@@ -282,16 +331,11 @@ API_EXPORT(jlong, initAndAttach, jobject platformSetting) {
             LOGGER_V("init.gtk: WebView added to GtkWindow window=%p webview=%p",
                      ctx->window, ctx->webview);
 
-            WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(ctx->webview);
-            if (!manager || !webkit_user_content_manager_register_script_message_handler(manager, "wvbridge")) {
+            if (!wvbridge::message_handler_connect(ctx.get())) {
                 set_failure(&created, &error, "Unable to register WebKit script message handler");
                 wvbridge::destroy_webview_on_gtk_thread(ctx.get());
                 return;
             }
-            ctx->web_message_handler_id = g_signal_connect(
-                manager, "script-message-received::wvbridge",
-                G_CALLBACK(wvbridge_script_message_received), ctx.get()
-            );
             ctx->window_button_press_handler_id = g_signal_connect(
                 ctx->window, "button-press-event",
                 G_CALLBACK(focus_on_button_press_cb), ctx.get()
@@ -305,12 +349,15 @@ API_EXPORT(jlong, initAndAttach, jobject platformSetting) {
                      static_cast<unsigned long>(ctx->window_button_press_handler_id),
                      static_cast<unsigned long>(ctx->webview_button_press_handler_id));
 
-            ctx->events = wvbridge::webview_events_create(ctx->webview, handle, &ctx->closing);
+            ctx->events = wvbridge::webview_events_create(ctx->webview, handle, &ctx->closing, ctx->crash_recovery);
             if (!ctx->events) {
                 set_failure(&created, &error, "Unable to create WebView event bridge");
                 wvbridge::destroy_webview_on_gtk_thread(ctx.get());
                 return;
             }
+            if (!wvbridge::data_scheme_attach(ctx->webview, handle)) {
+                LOGGER_W("init.gtk: binary data scheme unavailable ctx=%p", ctx.get());
+            }
 
             LOGGER_D("init.gtk: phase=realize-window ctx=%p window=%p", ctx.get(), ctx->window);
             gtk_widget_realize(ctx->window);
@@ -17,6 +17,21 @@ std::string jstring_to_string(JNIEnv *env, jstring value) {
     return result;
 }
 
+std::vector<std::string> jstring_array_to_vector(JNIEnv *env, jobjectArray values) {
+    std::vector<std::string> result;
+    if (!values) return result;
+
+    const jsize length = env->GetArrayLength(values);
+    result.reserve(static_cast<size_t>(length));
+    for (jsize i = 0; i < length; ++i) {
+        auto value = static_cast<jstring>(env->GetObjectArrayElement(values, i));
+        if (env->ExceptionCheck()) return {};
+        result.push_back(jstring_to_string(env, value));
+        env->DeleteLocalRef(value);
+    }
+    return result;
+}
+
 WebViewContext *require_context(JNIEnv *env, jlong handle) {
     LOGGER_I("require_context: handle=%lld", (long long)handle);
     if (handle == 0) {
@@ -35,17 +50,33 @@ WebViewContext *require_context(JNIEnv *env, jlong handle) {
     return ctx;
 }
 
-WebKitUserScript *add_document_start_script(WebKitWebView *webview, const std::string &source) {
+WebKitUserScript *add_document_start_script(WebKitWebView *webview, const std::string &source,
+                                            const wvbridge::UserScriptOptions &options) {
     LOGGER_V("add_document_start_script: source len=%zu", source.size());
     WebKitUserContentManager *manager = webkit_web_view_get_user_content_manager(webview);
-    WebKitUserScript *script = webkit_user_script_new(
-        source.c_str(),
-        WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
-        WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
-        nullptr,
-        nullptr
-    );
+    WebKitUserScript *script = wvbridge::new_document_start_user_script(source, options);
     webkit_user_content_manager_add_script(manager, script);
     LOGGER_V("add_document_start_script: script created=%p", (void*)script);
     return script;
 }
+
+std::shared_ptr<wvbridge::InternedScript> resolve_interned_script(JNIEnv *env, jstring key, jstring script) {
+    if (key == nullptr) {
+        LOGGER_E("resolve_interned_script: null key, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "key is null");
+        return nullptr;
+    }
+
+    const std::string id = jstring_to_string(env, key);
+    if (env->ExceptionCheck()) return nullptr;
+
+    if (script == nullptr) {
+        auto entry = wvbridge::script_cache_find(id);
+        if (!entry) throw_jni_exception(env, "java/util/NoSuchElementException", id.c_str());
+        return entry;
+    }
+
+    std::string source = jstring_to_string(env, script);
+    if (env->ExceptionCheck()) return nullptr;
+    return wvbridge::script_cache_put(id, std::move(source));
+}
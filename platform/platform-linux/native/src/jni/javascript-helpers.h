@@ -1,11 +1,21 @@
 #pragma once
 
 #include "libs_helpers.h"
+#include "script_cache.h"
 
 #include <wvbridge/logger.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 std::string jstring_to_string(JNIEnv *env, jstring value);
+std::vector<std::string> jstring_array_to_vector(JNIEnv *env, jobjectArray values);
 WebViewContext *require_context(JNIEnv *env, jlong handle);
-WebKitUserScript *add_document_start_script(WebKitWebView *webview, const std::string &source);
+WebKitUserScript *add_document_start_script(WebKitWebView *webview, const std::string &source,
+                                            const wvbridge::UserScriptOptions &options = {});
+
+// Looks up key in the script intern table, interning script first when it is non-null. Throws
+// java.util.NoSuchElementException and returns nullptr when script is null and key is not interned,
+// so the caller can retry with the source.
+std::shared_ptr<wvbridge::InternedScript> resolve_interned_script(JNIEnv *env, jstring key, jstring script);
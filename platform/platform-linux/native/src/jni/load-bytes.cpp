@@ -0,0 +1,69 @@
+#include "javascript-helpers.h"
+
+#include <wvbridge/java_runtime.h>
+
+namespace {
+
+// Drops the global reference that kept the direct buffer alive while WebKit used its memory. WebKit
+// releases the bytes on the GTK thread, which may not be attached to the JVM.
+void release_buffer(gpointer data) {
+    int attached = 0;
+    JNIEnv *env = java_runtime_get_env(&attached);
+    if (!env) {
+        LOGGER_W("loadBytes: no JNIEnv to release buffer ref=%p", data);
+        return;
+    }
+    env->DeleteGlobalRef(static_cast<jobject>(data));
+    java_runtime_detach_env(attached);
+}
+
+} // namespace
+
+API_EXPORT(void, loadBytes, jlong handle, jobject buffer, jint offset, jint length,
+           jstring mimeType, jstring encoding, jstring baseUrl) {
+    LOGGER_I("loadBytes: handle=%lld offset=%d length=%d", (long long)handle, (int)offset, (int)length);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return;
+    if (buffer == nullptr) {
+        LOGGER_E("loadBytes: null buffer, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "buffer is null");
+        return;
+    }
+
+    auto *address = static_cast<char *>(env->GetDirectBufferAddress(buffer));
+    const jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (!address || offset < 0 || length < 0 || offset + static_cast<jlong>(length) > capacity) {
+        LOGGER_E("loadBytes: buffer is not direct or range is out of bounds, capacity=%lld", (long long)capacity);
+        throw_jni_exception(env, "java/lang/IllegalArgumentException", "buffer must be a direct ByteBuffer");
+        return;
+    }
+
+    const std::string mime = mimeType != nullptr ? jstring_to_string(env, mimeType) : std::string();
+    const std::string charset = encoding != nullptr ? jstring_to_string(env, encoding) : std::string();
+    const std::string base = baseUrl != nullptr ? jstring_to_string(env, baseUrl) : std::string();
+    if (env->ExceptionCheck()) {
+        LOGGER_W("loadBytes: JVM exception after jstring_to_string, aborting");
+        return;
+    }
+    LOGGER_V("loadBytes: mime=%s encoding=%s baseUrl=%s", mime.c_str(), charset.c_str(), base.c_str());
+
+    // WebKit reads the buffer in place; the global reference keeps it alive until WebKit is done.
+    jobject ref = env->NewGlobalRef(buffer);
+    GBytes *bytes = g_bytes_new_with_free_func(address + offset, static_cast<gsize>(length), release_buffer, ref);
+
+    wvbridge::gtk_run_on_thread_sync([ctx, bytes, &mime, &charset, &base] {
+        if (ctx->closing.load(std::memory_order_acquire) || !ctx->webview) {
+            LOGGER_V("loadBytes: ctx is closing or ctx->webview is null, aborting GTK work");
+            return;
+        }
+        webkit_web_view_load_bytes(
+            ctx->webview,
+            bytes,
+            mime.empty() ? nullptr : mime.c_str(),
+            charset.empty() ? nullptr : charset.c_str(),
+            base.empty() ? nullptr : base.c_str()
+        );
+    });
+    g_bytes_unref(bytes);
+}
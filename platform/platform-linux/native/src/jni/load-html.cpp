@@ -0,0 +1,29 @@
+#include "javascript-helpers.h"
+
+API_EXPORT(void, loadHtml, jlong handle, jstring html, jstring baseUrl) {
+    LOGGER_I("loadHtml: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return;
+    if (html == nullptr) {
+        LOGGER_E("loadHtml: null html, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "html is null");
+        return;
+    }
+
+    const std::string content = jstring_to_string(env, html);
+    const std::string base = baseUrl != nullptr ? jstring_to_string(env, baseUrl) : std::string();
+    if (env->ExceptionCheck()) {
+        LOGGER_W("loadHtml: JVM exception after jstring_to_string, aborting");
+        return;
+    }
+    LOGGER_V("loadHtml: length=%zu baseUrl=%s", content.size(), base.c_str());
+
+    wvbridge::gtk_run_on_thread_sync([ctx, &content, &base] {
+        if (ctx->closing.load(std::memory_order_acquire) || !ctx->webview) {
+            LOGGER_V("loadHtml: ctx is closing or ctx->webview is null, aborting GTK work");
+            return;
+        }
+        webkit_web_view_load_html(ctx->webview, content.c_str(), base.empty() ? nullptr : base.c_str());
+    });
+}
@@ -1,4 +1,5 @@
 #include "libs_helpers.h"
+#include "prerender.h"
 #include <wvbridge/logger.h>
 
 API_EXPORT(void, loadUrl, jlong handle, jstring url) {
@@ -46,6 +47,11 @@ API_EXPORT(void, loadUrl, jlong handle, jstring url) {
             uri = "about:blank";
         }
 
+        if (wvbridge::prerender_activate(ctx, uri)) {
+            LOGGER_V("loadUrl: swapped in prerendered uri=%s", uri);
+            return;
+        }
+
         LOGGER_V("loadUrl: calling webkit_web_view_load_uri with uri=%s", uri);
         webkit_web_view_load_uri(ctx->webview, uri);
     });
@@ -0,0 +1,54 @@
+#include "javascript-helpers.h"
+
+#include "app_scheme.h"
+
+API_EXPORT(void, mountAssetPack, jlong handle, jstring scheme, jstring path) {
+    LOGGER_I("mountAssetPack: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return;
+    if (scheme == nullptr) {
+        LOGGER_E("mountAssetPack: null scheme, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "scheme is null");
+        return;
+    }
+
+    const std::string name = jstring_to_string(env, scheme);
+    if (env->ExceptionCheck()) return;
+
+    // A null path unmounts the pack; opening happens here so a bad file is reported to the caller.
+    std::shared_ptr<wvbridge::AssetPack> pack;
+    if (path != nullptr) {
+        const std::string file = jstring_to_string(env, path);
+        if (env->ExceptionCheck()) return;
+
+        GError *error = nullptr;
+        pack = wvbridge::asset_pack_open(file, &error);
+        if (!pack) {
+            const std::string message = error ? error->message : "unable to open asset pack";
+            if (error) g_error_free(error);
+            LOGGER_E("mountAssetPack: %s", message.c_str());
+            throw_jni_exception(env, "java/io/IOException", message.c_str());
+            return;
+        }
+    }
+
+    bool webviewAvailable = false;
+    bool mounted = false;
+    wvbridge::gtk_run_on_thread_sync([ctx, handle, &name, &pack, &webviewAvailable, &mounted] {
+        if (!ctx->webview) {
+            LOGGER_V("mountAssetPack: ctx->webview is null in GTK thread");
+            return;
+        }
+        webviewAvailable = true;
+        mounted = wvbridge::app_scheme_mount_pack(ctx->webview, handle, name.c_str(), pack);
+    });
+
+    if (!webviewAvailable) {
+        LOGGER_E("mountAssetPack: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+    } else if (!mounted) {
+        throw_jni_exception(env, "java/lang/UnsupportedOperationException",
+                            "custom URI schemes require WebKitGTK 2.36 or newer");
+    }
+}
@@ -0,0 +1,44 @@
+#include "javascript-helpers.h"
+
+#include <algorithm>
+
+#include "prerender.h"
+
+API_EXPORT(jlong, prerender, jlong handle, jstring url, jint maxCount, jlong ttlMillis) {
+    LOGGER_I("prerender: handle=%lld maxCount=%d ttl=%lldms", (long long)handle, (int)maxCount, (long long)ttlMillis);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return 0;
+    if (url == nullptr) {
+        LOGGER_E("prerender: null url, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "url is null");
+        return 0;
+    }
+
+    const std::string uri = jstring_to_string(env, url);
+    if (env->ExceptionCheck()) {
+        LOGGER_W("prerender: JVM exception after jstring_to_string, aborting");
+        return 0;
+    }
+    const unsigned int max_count = static_cast<unsigned int>(std::max<jint>(maxCount, 0));
+    const guint ttl = static_cast<guint>(std::clamp<jlong>(ttlMillis, 1, G_MAXUINT));
+
+    bool webviewAvailable = true;
+    jlong id = 0;
+    wvbridge::gtk_run_on_thread_sync([ctx, &uri, max_count, ttl, &webviewAvailable, &id] {
+        if (ctx->closing.load(std::memory_order_acquire) || !ctx->webview) {
+            LOGGER_V("prerender: ctx is closing or ctx->webview is null in GTK thread");
+            webviewAvailable = false;
+            return;
+        }
+        id = wvbridge::prerender_start(ctx, uri, max_count, ttl);
+    });
+
+    if (!webviewAvailable) {
+        LOGGER_E("prerender: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+        return 0;
+    }
+    LOGGER_V("prerender: id=%lld", (long long)id);
+    return id;
+}
@@ -1,5 +1,35 @@
 #include "javascript-helpers.h"
 
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+// add runs on the GTK thread and returns the WebKitUserScript it attached to the webview; the
+// reference it returns is owned by ctx->document_start_hooks.
+jlong register_document_start_hook(JNIEnv *env, WebViewContext *ctx,
+                                   const std::function<WebKitUserScript *(WebKitWebView *)> &add) {
+    jlong hookId = 0;
+    LOGGER_V("registerDocumentStartHook: dispatching to GTK thread");
+    wvbridge::gtk_run_on_thread_sync([ctx, &add, &hookId] {
+        if (!ctx->webview) {
+            LOGGER_V("registerDocumentStartHook: ctx->webview is null in GTK thread");
+            return;
+        }
+        hookId = ctx->next_document_start_hook_id++;
+        ctx->document_start_hooks[hookId] = add(ctx->webview);
+        LOGGER_V("registerDocumentStartHook: hookId=%lld", (long long)hookId);
+    });
+
+    if (hookId == 0) {
+        LOGGER_E("registerDocumentStartHook: hookId is 0, webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+    }
+    return hookId;
+}
+
+} // namespace
+
 API_EXPORT(jlong, registerDocumentStartHook, jlong handle, jstring script) {
     LOGGER_I("registerDocumentStartHook: handle=%lld", (long long)handle);
 
@@ -18,21 +48,44 @@ API_EXPORT(jlong, registerDocumentStartHook, jlong handle, jstring script) {
     }
     LOGGER_V("registerDocumentStartHook: source len=%zu", source.size());
 
-    jlong hookId = 0;
-    LOGGER_V("registerDocumentStartHook: dispatching to GTK thread");
-    wvbridge::gtk_run_on_thread_sync([ctx, source, &hookId] {
-        if (!ctx->webview) {
-            LOGGER_V("registerDocumentStartHook: ctx->webview is null in GTK thread");
-            return;
-        }
-        hookId = ctx->next_document_start_hook_id++;
-        ctx->document_start_hooks[hookId] = add_document_start_script(ctx->webview, source);
-        LOGGER_V("registerDocumentStartHook: hookId=%lld", (long long)hookId);
+    return register_document_start_hook(env, ctx, [&source](WebKitWebView *webview) {
+        return add_document_start_script(webview, source);
     });
+}
 
-    if (hookId == 0) {
-        LOGGER_E("registerDocumentStartHook: hookId is 0, webview not available");
-        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
-    }
-    return hookId;
+API_EXPORT(jlong, registerInternedDocumentStartHook, jlong handle, jstring key, jstring script,
+           jboolean mainFrameOnly, jobjectArray allowList, jobjectArray blockList) {
+    LOGGER_I("registerInternedDocumentStartHook: handle=%lld mainFrameOnly=%d", (long long)handle, mainFrameOnly ? 1 : 0);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return 0;
+
+    wvbridge::UserScriptOptions options;
+    options.main_frame_only = mainFrameOnly == JNI_TRUE;
+    options.allow_list = jstring_array_to_vector(env, allowList);
+    options.block_list = jstring_array_to_vector(env, blockList);
+    if (env->ExceptionCheck()) return 0;
+
+    auto entry = resolve_interned_script(env, key, script);
+    if (!entry) return 0;
+
+    return register_document_start_hook(env, ctx, [ctx, &entry, &options](WebKitWebView *webview) {
+        WebKitUserScript *shared = wvbridge::script_cache_user_script(entry, options);
+        const bool attached = std::any_of(
+            ctx->document_start_hooks.begin(),
+            ctx->document_start_hooks.end(),
+            [shared](const auto &hook) { return hook.second == shared; }
+        );
+        if (attached) {
+            // Removing a script removes every copy of it from the manager, so a second hook with
+            // the same source on this webview needs its own object.
+            LOGGER_V("registerInternedDocumentStartHook: source already attached, creating a copy");
+            webkit_user_script_unref(shared);
+            return add_document_start_script(webview, entry->source, options);
+        }
+
+        webkit_user_content_manager_add_script(webkit_web_view_get_user_content_manager(webview), shared);
+        LOGGER_V("registerInternedDocumentStartHook: attached shared script=%p", (void *)shared);
+        return shared;
+    });
 }
@@ -0,0 +1,37 @@
+#include "javascript-helpers.h"
+
+#include "app_scheme.h"
+
+API_EXPORT(void, registerUriScheme, jlong handle, jstring scheme) {
+    LOGGER_I("registerUriScheme: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return;
+    if (scheme == nullptr) {
+        LOGGER_E("registerUriScheme: null scheme, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "scheme is null");
+        return;
+    }
+
+    const std::string name = jstring_to_string(env, scheme);
+    if (env->ExceptionCheck()) return;
+
+    bool webviewAvailable = false;
+    bool registered = false;
+    wvbridge::gtk_run_on_thread_sync([ctx, handle, &name, &webviewAvailable, &registered] {
+        if (!ctx->webview) {
+            LOGGER_V("registerUriScheme: ctx->webview is null in GTK thread");
+            return;
+        }
+        webviewAvailable = true;
+        registered = wvbridge::app_scheme_register(ctx->webview, handle, name.c_str());
+    });
+
+    if (!webviewAvailable) {
+        LOGGER_E("registerUriScheme: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+    } else if (!registered) {
+        throw_jni_exception(env, "java/lang/UnsupportedOperationException",
+                            "custom URI schemes require WebKitGTK 2.36 or newer");
+    }
+}
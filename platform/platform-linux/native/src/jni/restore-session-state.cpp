@@ -0,0 +1,41 @@
+#include "javascript-helpers.h"
+
+#include "session_state.h"
+
+API_EXPORT(void, restoreSessionState, jlong handle, jbyteArray state) {
+    LOGGER_I("restoreSessionState: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return;
+
+    jsize length = env->GetArrayLength(state);
+    auto *data = static_cast<jbyte *>(g_malloc(length > 0 ? length : 1));
+    env->GetByteArrayRegion(state, 0, length, data);
+    GBytes *bytes = g_bytes_new_take(data, length);
+
+    bool webviewAvailable = false;
+    bool valid = false;
+    wvbridge::gtk_run_on_thread_sync([ctx, bytes, &webviewAvailable, &valid] {
+        if (!ctx->webview) {
+            LOGGER_V("restoreSessionState: ctx->webview is null in GTK thread");
+            return;
+        }
+        webviewAvailable = true;
+        WebKitWebViewSessionState *session_state = webkit_web_view_session_state_new(bytes);
+        if (!session_state) return;
+        valid = true;
+        wvbridge::session_state_apply(ctx->webview, session_state);
+        webkit_web_view_session_state_unref(session_state);
+    });
+    g_bytes_unref(bytes);
+
+    if (!webviewAvailable) {
+        LOGGER_E("restoreSessionState: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+        return;
+    }
+    if (!valid) {
+        LOGGER_E("restoreSessionState: invalid session state, size=%d", (int)length);
+        throw_jni_exception(env, "java/lang/IllegalArgumentException", "invalid session state");
+    }
+}
@@ -0,0 +1,29 @@
+#include "javascript-helpers.h"
+
+#include "web_process.h"
+
+API_EXPORT(jboolean, restoreWebProcess, jlong handle) {
+    LOGGER_I("restoreWebProcess: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return JNI_FALSE;
+
+    bool webviewAvailable = false;
+    bool done = false;
+    wvbridge::gtk_run_on_thread_sync([ctx, &webviewAvailable, &done] {
+        if (!ctx->webview) {
+            LOGGER_V("restoreWebProcess: ctx->webview is null in GTK thread");
+            return;
+        }
+        webviewAvailable = true;
+        done = wvbridge::web_process_restore(ctx->webview);
+    });
+
+    if (!webviewAvailable) {
+        LOGGER_E("restoreWebProcess: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+        return JNI_FALSE;
+    }
+    LOGGER_V("restoreWebProcess: done=%d", done ? 1 : 0);
+    return done ? JNI_TRUE : JNI_FALSE;
+}
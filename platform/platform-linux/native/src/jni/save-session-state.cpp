@@ -0,0 +1,33 @@
+#include "javascript-helpers.h"
+
+#include "session_state.h"
+
+API_EXPORT(jbyteArray, saveSessionState, jlong handle) {
+    LOGGER_I("saveSessionState: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return nullptr;
+
+    GBytes *bytes = nullptr;
+    wvbridge::gtk_run_on_thread_sync([ctx, &bytes] {
+        if (!ctx->webview) {
+            LOGGER_V("saveSessionState: ctx->webview is null in GTK thread");
+            return;
+        }
+        bytes = wvbridge::session_state_save(ctx->webview);
+    });
+
+    if (!bytes) {
+        LOGGER_E("saveSessionState: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+        return nullptr;
+    }
+
+    gsize size = 0;
+    const auto *data = static_cast<const jbyte *>(g_bytes_get_data(bytes, &size));
+    jbyteArray result = env->NewByteArray(static_cast<jsize>(size));
+    if (result) env->SetByteArrayRegion(result, 0, static_cast<jsize>(size), data);
+    g_bytes_unref(bytes);
+    LOGGER_V("saveSessionState: size=%zu", size);
+    return result;
+}
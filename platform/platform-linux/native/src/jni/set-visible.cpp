@@ -0,0 +1,30 @@
+#include "libs_helpers.h"
+#include <wvbridge/logger.h>
+
+API_EXPORT(void, setVisible, jlong handle, jboolean visible) {
+    LOGGER_I("setVisible: handle=%lld visible=%d", (long long)handle, visible ? 1 : 0);
+    (void) thiz;
+
+    if (handle == 0) {
+        LOGGER_E("setVisible: null handle, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "handle is null");
+        return;
+    }
+    auto *ctx = (WebViewContext *) handle;
+
+    // The GTK child stays mapped under a hidden AWT parent, so WebKit would keep treating the page
+    // as visible. Unmapping it makes WebKit report the page as hidden and throttle timers,
+    // animation frames and rendering.
+    wvbridge::gtk_run_on_thread_sync([ctx, visible] {
+        if (ctx->closing.load(std::memory_order_acquire) || !ctx->window) {
+            LOGGER_V("setVisible: ctx is closing or has no window, aborting GTK work");
+            return;
+        }
+        if (visible) {
+            gtk_widget_show(ctx->window);
+        } else {
+            gtk_widget_hide(ctx->window);
+        }
+        LOGGER_V("setVisible: window=%p mapped=%d", ctx->window, gtk_widget_get_mapped(ctx->window) ? 1 : 0);
+    });
+}
@@ -0,0 +1,32 @@
+#include "javascript-helpers.h"
+
+#include "prerender.h"
+#include "web_process.h"
+
+API_EXPORT(jboolean, unloadWebProcess, jlong handle) {
+    LOGGER_I("unloadWebProcess: handle=%lld", (long long)handle);
+
+    auto *ctx = require_context(env, handle);
+    if (!ctx) return JNI_FALSE;
+
+    bool webviewAvailable = false;
+    bool done = false;
+    wvbridge::gtk_run_on_thread_sync([ctx, &webviewAvailable, &done] {
+        if (!ctx->webview) {
+            LOGGER_V("unloadWebProcess: ctx->webview is null in GTK thread");
+            return;
+        }
+        webviewAvailable = true;
+        // Unloading is meant to free memory; hidden prerendered pages would keep theirs.
+        wvbridge::prerender_clear(ctx);
+        done = wvbridge::web_process_unload(ctx->webview);
+    });
+
+    if (!webviewAvailable) {
+        LOGGER_E("unloadWebProcess: webview not available");
+        throw_jni_exception(env, "java/lang/RuntimeException", "webview is not available");
+        return JNI_FALSE;
+    }
+    LOGGER_V("unloadWebProcess: done=%d", done ? 1 : 0);
+    return done ? JNI_TRUE : JNI_FALSE;
+}
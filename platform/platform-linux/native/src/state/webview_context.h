@@ -5,6 +5,7 @@
 #include <atomic>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <string>
 
 #include <gtk/gtk.h>
@@ -12,9 +13,11 @@
 #include <webkit2/webkit2.h>
 
 #include <wvbridge/javascript.h>
+#include <wvbridge/webview-platform-settings.h>
 
 namespace wvbridge {
 struct WebViewEvents;
+struct PrerenderPool;
 }
 
 struct WebViewContext {
@@ -27,6 +30,7 @@ struct WebViewContext {
     GtkWidget *window = nullptr;
     WebKitWebView *webview = nullptr;
     wvbridge::WebViewEvents* events = nullptr;
+    wvbridge::PrerenderPool* prerenders = nullptr; // owned; created by the first prerender
 
     std::atomic_bool closing{false};
     std::atomic_bool attached{false};
@@ -39,4 +43,6 @@ struct WebViewContext {
     jlong next_web_message_handler_id = 1;
     std::mutex web_message_handlers_mutex;
     wvbridge::WebMessageHandlers web_message_handlers;
+    std::string content_filter_dir;
+    std::optional<WvBridgeLinuxCrashRecoverySetting> crash_recovery;
 };
@@ -0,0 +1,297 @@
+#include "app_scheme.h"
+
+#include <gio/gio.h>
+#include <glib.h>
+#include <libsoup/soup.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "wvbridge/native_bridge.h"
+#include <wvbridge/logger.h>
+
+namespace wvbridge {
+
+namespace {
+
+constexpr const char* POINTER_KEY = "wvbridge-app-scheme-pointer";
+constexpr const char* DEFAULT_MIME_TYPE = "application/octet-stream";
+constexpr const char* INDEX_DOCUMENT = "index.html";
+
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+
+// A GInputStream over a java.io.InputStream. GIO runs the synchronous read in its worker pool for
+// WebKit's asynchronous reads, so the JVM stream is never read on the GTK thread.
+struct JvmInputStream {
+    GInputStream parent_instance;
+    jobject stream;
+};
+
+struct JvmInputStreamClass {
+    GInputStreamClass parent_class;
+};
+
+G_DEFINE_TYPE(JvmInputStream, jvm_input_stream, G_TYPE_INPUT_STREAM)
+
+gssize jvm_input_stream_read(GInputStream* stream, void* buffer, gsize count, GCancellable*, GError** error) {
+    auto* self = reinterpret_cast<JvmInputStream*>(stream);
+    const jlong read = read_scheme_response_stream(self->stream, buffer, static_cast<jlong>(count));
+    if (read < 0) {
+        g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_FAILED, "scheme handler stream threw while reading");
+        return -1;
+    }
+    return static_cast<gssize>(read);
+}
+
+gboolean jvm_input_stream_close(GInputStream* stream, GCancellable*, GError**) {
+    auto* self = reinterpret_cast<JvmInputStream*>(stream);
+    close_scheme_response_stream(self->stream);
+    return TRUE;
+}
+
+void jvm_input_stream_finalize(GObject* object) {
+    auto* self = reinterpret_cast<JvmInputStream*>(object);
+    release_scheme_response_ref(self->stream);
+    self->stream = nullptr;
+    G_OBJECT_CLASS(jvm_input_stream_parent_class)->finalize(object);
+}
+
+void jvm_input_stream_class_init(JvmInputStreamClass* klass) {
+    G_OBJECT_CLASS(klass)->finalize = jvm_input_stream_finalize;
+    G_INPUT_STREAM_CLASS(klass)->read_fn = jvm_input_stream_read;
+    G_INPUT_STREAM_CLASS(klass)->close_fn = jvm_input_stream_close;
+}
+
+void jvm_input_stream_init(JvmInputStream* self) {
+    self->stream = nullptr;
+}
+
+GInputStream* jvm_input_stream_new(jobject stream) {
+    auto* self = static_cast<JvmInputStream*>(g_object_new(jvm_input_stream_get_type(), nullptr));
+    self->stream = stream;
+    return G_INPUT_STREAM(self);
+}
+
+jlong bound_pointer(WebKitWebView* webview) {
+    if (!webview) return 0;
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(g_object_get_data(G_OBJECT(webview), POINTER_KEY)));
+}
+
+// Takes ownership of headers.
+void finish(WebKitURISchemeRequest* request, GInputStream* body, gint64 length, guint status, const char* mime_type,
+            SoupMessageHeaders* headers = nullptr) {
+    WebKitURISchemeResponse* response = webkit_uri_scheme_response_new(body, length);
+    webkit_uri_scheme_response_set_status(response, status, nullptr);
+    webkit_uri_scheme_response_set_content_type(response, mime_type ? mime_type : DEFAULT_MIME_TYPE);
+    if (headers) webkit_uri_scheme_response_set_http_headers(response, headers);
+    webkit_uri_scheme_request_finish_with_response(request, response);
+    g_object_unref(response);
+}
+
+void finish_with_status(WebKitURISchemeRequest* request, guint status) {
+    GInputStream* empty = g_memory_input_stream_new();
+    finish(request, empty, 0, status, "text/plain");
+    g_object_unref(empty);
+}
+
+// Takes ownership of the body held by response. Buffers and files are served from their own
+// memory: direct ByteBuffers are wrapped in place and files are mapped, so neither is copied.
+GInputStream* take_body(wvbridge_scheme_response* response, gint64* length, GError** error) {
+    if (response->ref) {
+        GBytes* bytes = g_bytes_new_with_free_func(
+            response->buffer_data,
+            static_cast<gsize>(response->buffer_size),
+            [](gpointer ref) { release_scheme_response_ref(static_cast<jobject>(ref)); },
+            response->ref
+        );
+        response->ref = nullptr;
+        *length = static_cast<gint64>(g_bytes_get_size(bytes));
+        GInputStream* body = g_memory_input_stream_new_from_bytes(bytes);
+        g_bytes_unref(bytes);
+        return body;
+    }
+
+    if (response->path) {
+        GMappedFile* file = g_mapped_file_new(response->path, FALSE, error);
+        if (!file) return nullptr;
+        GBytes* bytes = g_mapped_file_get_bytes(file);
+        g_mapped_file_unref(file);
+        *length = static_cast<gint64>(g_bytes_get_size(bytes));
+        GInputStream* body = g_memory_input_stream_new_from_bytes(bytes);
+        g_bytes_unref(bytes);
+        return body;
+    }
+
+    GInputStream* body = jvm_input_stream_new(response->stream);
+    response->stream = nullptr;
+    *length = response->length >= 0 ? response->length : -1;
+    return body;
+}
+
+// pointer -> scheme -> mounted pack. Packs belong to the context rather than to one WebView, so
+// every WebView bound to the context serves them. Only touched on the GTK thread.
+std::map<jlong, std::map<std::string, std::shared_ptr<AssetPack>>>& mounted_packs() {
+    static auto* instance = new std::map<jlong, std::map<std::string, std::shared_ptr<AssetPack>>>();
+    return *instance;
+}
+
+// Serves the request from the asset pack mounted for scheme, straight from the mapping. Returns
+// false when no pack is mounted or the path is not in it.
+bool serve_from_pack(WebKitURISchemeRequest* request, jlong pointer, const char* scheme) {
+    const auto& packs = mounted_packs();
+    auto packs_it = packs.find(pointer);
+    if (packs_it == packs.end()) return false;
+    auto it = packs_it->second.find(scheme);
+    if (it == packs_it->second.end()) return false;
+    const std::shared_ptr<AssetPack>& pack = it->second;
+
+    gchar* decoded = g_uri_unescape_string(webkit_uri_scheme_request_get_path(request), nullptr);
+    if (!decoded) return false;
+    std::string path = decoded;
+    g_free(decoded);
+    while (!path.empty() && path.front() == '/') path.erase(0, 1);
+    if (path.empty() || path.back() == '/') path += INDEX_DOCUMENT;
+
+    AssetPack::Entry entry{};
+    if (!pack->find(path, &entry)) return false;
+
+    const std::string etag(entry.etag);
+    const std::string mime_type(entry.mime_type);
+    SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    if (!etag.empty()) soup_message_headers_append(headers, "ETag", etag.c_str());
+    soup_message_headers_append(headers, "Cache-Control", "no-cache");
+
+    SoupMessageHeaders* request_headers = webkit_uri_scheme_request_get_http_headers(request);
+    const char* if_none_match = request_headers ? soup_message_headers_get_one(request_headers, "If-None-Match") : nullptr;
+    if (!etag.empty() && g_strcmp0(if_none_match, etag.c_str()) == 0) {
+        GInputStream* empty = g_memory_input_stream_new();
+        finish(request, empty, 0, 304, mime_type.c_str(), headers);
+        g_object_unref(empty);
+        return true;
+    }
+
+    GBytes* bytes = pack->entry_bytes(entry);
+    GInputStream* body = g_memory_input_stream_new_from_bytes(bytes);
+    g_bytes_unref(bytes);
+    gint64 length = static_cast<gint64>(entry.length);
+    if (entry.flags & AssetPack::FLAG_GZIP) {
+        GZlibDecompressor* decompressor = g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_GZIP);
+        GInputStream* decoded = g_converter_input_stream_new(body, G_CONVERTER(decompressor));
+        g_object_unref(decompressor);
+        g_object_unref(body);
+        body = decoded;
+        length = -1;
+    }
+
+    finish(request, body, length, 200, mime_type.c_str(), headers);
+    g_object_unref(body);
+    return true;
+}
+
+void app_scheme_request_cb(WebKitURISchemeRequest* request, gpointer user_data) {
+    const auto* scheme = static_cast<const char*>(user_data);
+    WebKitWebView* webview = webkit_uri_scheme_request_get_web_view(request);
+    const jlong pointer = bound_pointer(webview);
+    if (pointer == 0) {
+        GError* error = g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "%s: no handler for this WebView", scheme);
+        webkit_uri_scheme_request_finish_error(request, error);
+        g_error_free(error);
+        return;
+    }
+
+    if (serve_from_pack(request, pointer, scheme)) return;
+
+    const gchar* uri = webkit_uri_scheme_request_get_uri(request);
+    const gchar* method = webkit_uri_scheme_request_get_http_method(request);
+    LOGGER_D("app_scheme: request scheme=%s uri=%s method=%s", scheme, uri, method ? method : "GET");
+
+    wvbridge_scheme_response response{};
+    if (!notify_scheme_request_to_jvm(pointer, scheme, uri, method ? method : "GET", &response)) {
+        finish_with_status(request, 404);
+        return;
+    }
+
+    gint64 length = -1;
+    GError* error = nullptr;
+    GInputStream* body = take_body(&response, &length, &error);
+    if (!body) {
+        LOGGER_W("app_scheme: unable to open body uri=%s reason=%s", uri, error ? error->message : "unknown");
+        const bool missing = error && g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+        if (error) g_error_free(error);
+        free_scheme_response(&response);
+        finish_with_status(request, missing ? 404 : 500);
+        return;
+    }
+
+    finish(request, body, length, static_cast<guint>(response.status), response.mime_type);
+    g_object_unref(body);
+    free_scheme_response(&response);
+}
+
+#endif
+
+} // namespace
+
+bool app_scheme_register(WebKitWebView* webview, jlong pointer, const char* scheme) {
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+    if (!webview || !scheme) return false;
+
+    WebKitWebContext* context = webkit_web_view_get_context(webview);
+    const std::string registered_key = std::string("wvbridge-app-scheme:") + scheme;
+    if (context && !g_object_get_data(G_OBJECT(context), registered_key.c_str())) {
+        LOGGER_D("app_scheme: registering scheme=%s context=%p", scheme, context);
+        webkit_web_context_register_uri_scheme(context, scheme, app_scheme_request_cb, g_strdup(scheme), g_free);
+        WebKitSecurityManager* security = webkit_web_context_get_security_manager(context);
+        webkit_security_manager_register_uri_scheme_as_secure(security, scheme);
+        webkit_security_manager_register_uri_scheme_as_cors_enabled(security, scheme);
+        g_object_set_data(G_OBJECT(context), registered_key.c_str(), GINT_TO_POINTER(1));
+    }
+
+    g_object_set_data(G_OBJECT(webview), POINTER_KEY, reinterpret_cast<gpointer>(static_cast<intptr_t>(pointer)));
+    return true;
+#else
+    LOGGER_W("app_scheme: custom scheme handlers require WebKitGTK 2.36 or newer");
+    (void) webview;
+    (void) pointer;
+    (void) scheme;
+    return false;
+#endif
+}
+
+bool app_scheme_mount_pack(WebKitWebView* webview, jlong pointer, const char* scheme,
+                           std::shared_ptr<AssetPack> pack) {
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+    if (!app_scheme_register(webview, pointer, scheme)) return false;
+
+    auto& packs = mounted_packs()[pointer];
+    if (pack) {
+        packs[scheme] = std::move(pack);
+    } else {
+        packs.erase(scheme);
+    }
+    return true;
+#else
+    (void) webview;
+    (void) pointer;
+    (void) scheme;
+    (void) pack;
+    return false;
+#endif
+}
+
+void app_scheme_bind(WebKitWebView* webview, jlong pointer) {
+    if (!webview) return;
+    g_object_set_data(G_OBJECT(webview), POINTER_KEY, reinterpret_cast<gpointer>(static_cast<intptr_t>(pointer)));
+}
+
+void app_scheme_detach(WebKitWebView* webview) {
+    if (!webview) return;
+    g_object_set_data(G_OBJECT(webview), POINTER_KEY, nullptr);
+}
+
+void app_scheme_release(jlong pointer) {
+    mounted_packs().erase(pointer);
+}
+
+} // namespace wvbridge
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <jni.h>
+
+#include <memory>
+
+#include <webkit2/webkit2.h>
+
+#include "asset_pack.h"
+
+namespace wvbridge {
+
+// Routes requests for scheme in webview to the JVM scheme handlers bound to
+// pointer. The scheme is registered once per WebKitWebContext and marked secure
+// and CORS-enabled. Must run on the GTK thread.
+bool app_scheme_register(WebKitWebView* webview, jlong pointer, const char* scheme);
+
+// Serves scheme from pack before consulting the JVM, in webview and every other
+// WebView bound to pointer. Paths missing from the pack fall through to the JVM
+// handler, if any. A null pack unmounts the current one. Must run on the GTK
+// thread.
+bool app_scheme_mount_pack(WebKitWebView* webview, jlong pointer, const char* scheme,
+                           std::shared_ptr<AssetPack> pack);
+
+// Routes requests from webview for schemes already registered in its web
+// context to pointer. Must run on the GTK thread.
+void app_scheme_bind(WebKitWebView* webview, jlong pointer);
+
+// Unbinds webview so later requests fail instead of reaching a closed context.
+// Must run on the GTK thread.
+void app_scheme_detach(WebKitWebView* webview);
+
+// Unmounts every asset pack mounted for pointer. Must run on the GTK thread.
+void app_scheme_release(jlong pointer);
+
+} // namespace wvbridge
@@ -0,0 +1,126 @@
+#include "asset_pack.h"
+
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+
+#include <wvbridge/logger.h>
+
+namespace wvbridge {
+
+namespace {
+
+constexpr char MAGIC[4] = {'W', 'V', 'P', 'K'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t RECORD_SIZE = 48;
+
+uint32_t read_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+uint64_t read_u64(const uint8_t* p) {
+    return static_cast<uint64_t>(read_u32(p)) | static_cast<uint64_t>(read_u32(p + 4)) << 32;
+}
+
+bool in_bounds(uint64_t offset, uint64_t length, uint64_t size) {
+    return offset <= size && length <= size - offset;
+}
+
+std::mutex g_packs_mutex;
+std::map<std::string, std::weak_ptr<AssetPack>> g_packs;
+
+} // namespace
+
+AssetPack::~AssetPack() {
+    g_bytes_unref(bytes_);
+}
+
+const uint8_t* AssetPack::record(uint32_t index) const {
+    const auto* data = static_cast<const uint8_t*>(g_bytes_get_data(bytes_, nullptr));
+    return data + HEADER_SIZE + static_cast<size_t>(index) * RECORD_SIZE;
+}
+
+std::string_view AssetPack::string_at(uint32_t offset, uint32_t length) const {
+    const auto* data = static_cast<const char*>(g_bytes_get_data(bytes_, nullptr));
+    return std::string_view(data + offset, length);
+}
+
+bool AssetPack::find(std::string_view path, Entry* entry) const {
+    uint32_t low = 0;
+    uint32_t high = count_;
+    while (low < high) {
+        const uint32_t mid = low + (high - low) / 2;
+        const uint8_t* r = record(mid);
+        const int order = string_at(read_u32(r), read_u32(r + 4)).compare(path);
+        if (order < 0) {
+            low = mid + 1;
+        } else if (order > 0) {
+            high = mid;
+        } else {
+            entry->mime_type = string_at(read_u32(r + 8), read_u32(r + 12));
+            entry->etag = string_at(read_u32(r + 16), read_u32(r + 20));
+            entry->offset = read_u64(r + 24);
+            entry->length = read_u64(r + 32);
+            entry->flags = read_u32(r + 40);
+            return true;
+        }
+    }
+    return false;
+}
+
+GBytes* AssetPack::entry_bytes(const Entry& entry) const {
+    return g_bytes_new_from_bytes(bytes_, static_cast<gsize>(entry.offset), static_cast<gsize>(entry.length));
+}
+
+std::shared_ptr<AssetPack> asset_pack_open(const std::string& path, GError** error) {
+    std::lock_guard<std::mutex> lock(g_packs_mutex);
+    // Drop packs whose last WebView has unmounted them, so the map does not grow with every path
+    // ever mounted.
+    for (auto it = g_packs.begin(); it != g_packs.end();) {
+        it = it->second.expired() ? g_packs.erase(it) : std::next(it);
+    }
+    auto cached_it = g_packs.find(path);
+    if (cached_it != g_packs.end()) {
+        if (auto cached = cached_it->second.lock()) return cached;
+    }
+
+    GMappedFile* file = g_mapped_file_new(path.c_str(), FALSE, error);
+    if (!file) return nullptr;
+    GBytes* bytes = g_mapped_file_get_bytes(file);
+    g_mapped_file_unref(file);
+
+    gsize size = 0;
+    const auto* data = static_cast<const uint8_t*>(g_bytes_get_data(bytes, &size));
+    auto fail = [&](const char* reason) -> std::shared_ptr<AssetPack> {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "%s: %s", path.c_str(), reason);
+        g_bytes_unref(bytes);
+        return nullptr;
+    };
+
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) return fail("not an asset pack");
+    if (read_u32(data + 4) != VERSION) return fail("unsupported asset pack version");
+
+    const uint32_t count = read_u32(data + 8);
+    if (!in_bounds(HEADER_SIZE, static_cast<uint64_t>(count) * RECORD_SIZE, size)) return fail("truncated index");
+
+    // Validate every record once so lookups never need bounds checks.
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* r = data + HEADER_SIZE + static_cast<size_t>(i) * RECORD_SIZE;
+        if (!in_bounds(read_u32(r), read_u32(r + 4), size) ||
+            !in_bounds(read_u32(r + 8), read_u32(r + 12), size) ||
+            !in_bounds(read_u32(r + 16), read_u32(r + 20), size) ||
+            !in_bounds(read_u64(r + 24), read_u64(r + 32), size)) {
+            return fail("index entry out of bounds");
+        }
+    }
+
+    std::shared_ptr<AssetPack> pack(new AssetPack(bytes, count));
+    g_packs[path] = pack;
+    LOGGER_D("asset_pack: mapped path=%s entries=%u bytes=%zu", path.c_str(), count, static_cast<size_t>(size));
+    return pack;
+}
+
+} // namespace wvbridge
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glib.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace wvbridge {
+
+// A read-only asset archive built by `top.kagg886.wvbridge.scheme.AssetPacks` and
+// mapped into memory once. All integers are little-endian:
+//
+//   header  "WVPK" | u32 version (1) | u32 entry count | u32 reserved
+//   index   entry count × 48-byte records sorted by path bytes:
+//           u32 path offset | u32 path length | u32 mime offset | u32 mime length |
+//           u32 etag offset | u32 etag length | u64 data offset | u64 data length |
+//           u32 flags | u32 reserved
+//   strings and data, addressed by the offsets above
+//
+// Offsets are relative to the start of the file. Flag 1 marks gzip-compressed data.
+class AssetPack {
+public:
+    static constexpr uint32_t FLAG_GZIP = 1;
+
+    struct Entry {
+        std::string_view mime_type;
+        std::string_view etag;
+        uint64_t offset;
+        uint64_t length;
+        uint32_t flags;
+    };
+
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Finds path (without a leading '/') by binary search over the index.
+    bool find(std::string_view path, Entry* entry) const;
+
+    // Returns a new reference to the bytes of entry; they alias the mapping.
+    GBytes* entry_bytes(const Entry& entry) const;
+
+private:
+    friend std::shared_ptr<AssetPack> asset_pack_open(const std::string& path, GError** error);
+
+    AssetPack(GBytes* bytes, uint32_t count) : bytes_(bytes), count_(count) {}
+
+    const uint8_t* record(uint32_t index) const;
+    std::string_view string_at(uint32_t offset, uint32_t length) const;
+
+    GBytes* bytes_;
+    uint32_t count_;
+};
+
+// Maps the pack at path, validating its index. Packs are cached by path, so
+// every WebView serving the same pack shares one mapping. Thread-safe.
+std::shared_ptr<AssetPack> asset_pack_open(const std::string& path, GError** error);
+
+} // namespace wvbridge
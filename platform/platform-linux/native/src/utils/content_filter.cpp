@@ -0,0 +1,306 @@
+#include "content_filter.h"
+
+#include <glib.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <wvbridge/logger.h>
+
+#include "wvbridge/native_bridge.h"
+
+namespace wvbridge {
+
+namespace {
+
+#if WEBKIT_CHECK_VERSION(2, 26, 0)
+
+constexpr const char* VIEW_FILTERS_KEY = "wvbridge-content-filters";
+
+// name -> stored identifier of the list a WebView currently wants.
+using ViewFilters = std::map<std::string, std::string>;
+
+struct LoadedFilter {
+    WebKitUserContentFilter* filter = nullptr; // owned
+    bool loading = false;
+    std::shared_ptr<const std::string> rules;  // kept only until compiled
+    std::vector<std::pair<WebKitWebView*, std::string>> waiting; // owned view references
+};
+
+struct FilterRegistry {
+    std::map<std::string, WebKitUserContentFilterStore*> stores; // store dir -> owned store
+    std::map<std::string, LoadedFilter> filters;                 // filter_key() -> filter
+};
+
+// Only touched on the GTK thread.
+FilterRegistry& registry() {
+    static auto* instance = new FilterRegistry(); // intentionally leaked; outlives static destructors
+    return *instance;
+}
+
+struct LoadRequest {
+    std::string store_dir;
+    std::string name;
+    std::string id;
+};
+
+std::string filter_key(const std::string& store_dir, const std::string& id) {
+    return store_dir + '\n' + id;
+}
+
+ViewFilters& view_filters(WebKitWebView* webview) {
+    auto* filters = static_cast<ViewFilters*>(g_object_get_data(G_OBJECT(webview), VIEW_FILTERS_KEY));
+    if (!filters) {
+        filters = new ViewFilters();
+        g_object_set_data_full(G_OBJECT(webview), VIEW_FILTERS_KEY, filters,
+                               [](gpointer data) { delete static_cast<ViewFilters*>(data); });
+    }
+    return *filters;
+}
+
+bool view_wants(WebKitWebView* webview, const std::string& name, const std::string& id) {
+    const auto& filters = view_filters(webview);
+    auto it = filters.find(name);
+    return it != filters.end() && it->second == id;
+}
+
+WebKitUserContentFilterStore* store_for(const std::string& store_dir) {
+    auto& store = registry().stores[store_dir];
+    if (!store) {
+        store = webkit_user_content_filter_store_new(store_dir.c_str());
+        LOGGER_D("content_filter: opened store dir=%s", store_dir.c_str());
+    }
+    return store;
+}
+
+void remove_stale_identifiers(GObject* source, GAsyncResult* result, gpointer data) {
+    std::unique_ptr<LoadRequest> request(static_cast<LoadRequest*>(data));
+    auto* store = WEBKIT_USER_CONTENT_FILTER_STORE(source);
+    gchar** identifiers = webkit_user_content_filter_store_fetch_identifiers_finish(store, result);
+    if (!identifiers) return;
+
+    const std::string prefix = request->name + '.';
+    for (gchar** it = identifiers; *it; ++it) {
+        const std::string id = *it;
+        if (id == request->id || id.compare(0, prefix.size(), prefix) != 0) continue;
+        LOGGER_D("content_filter: removing stale id=%s", id.c_str());
+        webkit_user_content_filter_store_remove(
+            store, id.c_str(), nullptr,
+            [](GObject* store, GAsyncResult* result, gpointer) {
+                webkit_user_content_filter_store_remove_finish(WEBKIT_USER_CONTENT_FILTER_STORE(store), result, nullptr);
+            },
+            nullptr
+        );
+    }
+    g_strfreev(identifiers);
+}
+
+// Hands filter (or its absence) to every WebView waiting for the request.
+void finish_load(const LoadRequest& request, WebKitUserContentFilter* filter) {
+    auto& filters = registry().filters;
+    auto it = filters.find(filter_key(request.store_dir, request.id));
+    if (it == filters.end()) {
+        if (filter) webkit_user_content_filter_unref(filter);
+        return;
+    }
+
+    auto waiting = std::move(it->second.waiting);
+    if (filter) {
+        it->second.filter = filter;
+        it->second.loading = false;
+        it->second.rules.reset();
+    } else {
+        filters.erase(it);
+    }
+
+    for (auto& [webview, name] : waiting) {
+        if (view_wants(webview, name, request.id)) {
+            if (filter) {
+                webkit_user_content_manager_add_filter(webkit_web_view_get_user_content_manager(webview), filter);
+            } else {
+                view_filters(webview).erase(name);
+            }
+        }
+        g_object_unref(webview);
+    }
+    if (!filter) return;
+
+    // Older revisions of the list are no longer attached to new WebViews.
+    const std::string prefix = filter_key(request.store_dir, request.name + '.');
+    for (auto stale = filters.lower_bound(prefix); stale != filters.end() && stale->first.compare(0, prefix.size(), prefix) == 0;) {
+        if (stale->second.loading || stale->first == filter_key(request.store_dir, request.id)) {
+            ++stale;
+            continue;
+        }
+        webkit_user_content_filter_unref(stale->second.filter);
+        stale = filters.erase(stale);
+    }
+}
+
+void save_finished(GObject* source, GAsyncResult* result, gpointer data) {
+    std::unique_ptr<LoadRequest> request(static_cast<LoadRequest*>(data));
+    GError* error = nullptr;
+    WebKitUserContentFilter* filter = webkit_user_content_filter_store_save_finish(
+        WEBKIT_USER_CONTENT_FILTER_STORE(source), result, &error
+    );
+    if (!filter) {
+        const std::string reason = error && error->message ? error->message : "unknown";
+        LOGGER_W("content_filter: unable to compile id=%s reason=%s", request->id.c_str(), reason.c_str());
+        if (error) g_error_free(error);
+        finish_load(*request, nullptr);
+        const std::string hash = request->id.substr(request->name.size() + 1);
+        notify_content_filter_failed_to_jvm(request->name.c_str(), hash.c_str(), reason.c_str());
+        return;
+    }
+
+    LOGGER_I("content_filter: compiled id=%s dir=%s", request->id.c_str(), request->store_dir.c_str());
+    finish_load(*request, filter);
+    webkit_user_content_filter_store_fetch_identifiers(
+        WEBKIT_USER_CONTENT_FILTER_STORE(source), nullptr, remove_stale_identifiers, request.release()
+    );
+}
+
+void lookup_finished(GObject* source, GAsyncResult* result, gpointer data) {
+    std::unique_ptr<LoadRequest> request(static_cast<LoadRequest*>(data));
+    auto* store = WEBKIT_USER_CONTENT_FILTER_STORE(source);
+    GError* error = nullptr;
+    WebKitUserContentFilter* filter = webkit_user_content_filter_store_lookup_finish(store, result, &error);
+    if (filter) {
+        LOGGER_D("content_filter: loaded compiled id=%s", request->id.c_str());
+        finish_load(*request, filter);
+        return;
+    }
+    LOGGER_D("content_filter: compiling id=%s reason=%s", request->id.c_str(), error ? error->message : "unknown");
+    if (error) g_error_free(error);
+
+    auto it = registry().filters.find(filter_key(request->store_dir, request->id));
+    if (it == registry().filters.end() || !it->second.rules) {
+        finish_load(*request, nullptr);
+        return;
+    }
+
+    // WebKit reads the source in place; the bytes keep the string alive until it is done.
+    auto* rules = new std::shared_ptr<const std::string>(std::move(it->second.rules));
+    GBytes* bytes = g_bytes_new_with_free_func(
+        (*rules)->data(), (*rules)->size(),
+        [](gpointer data) { delete static_cast<std::shared_ptr<const std::string>*>(data); },
+        rules
+    );
+    webkit_user_content_filter_store_save(store, request->id.c_str(), bytes, nullptr, save_finished, request.release());
+    g_bytes_unref(bytes);
+}
+
+#endif
+
+} // namespace
+
+std::string content_filter_store_dir(WebKitWebView* webview, const std::string& data_dir) {
+    std::string base = data_dir;
+    if (base.empty()) {
+        // Lists are named after their identifier, so a directory shared between applications would
+        // let one replace or delete another's compiled lists.
+        WebKitWebsiteDataManager* manager = webkit_web_context_get_website_data_manager(webkit_web_view_get_context(webview));
+        G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+        const gchar* context_dir = manager && !webkit_website_data_manager_is_ephemeral(manager)
+            ? webkit_website_data_manager_get_base_data_directory(manager)
+            : nullptr;
+        G_GNUC_END_IGNORE_DEPRECATIONS
+        if (!context_dir) return "";
+        base = context_dir;
+    }
+
+    gchar* dir = g_build_filename(base.c_str(), "content-filters", nullptr);
+    std::string result = dir;
+    g_free(dir);
+    return result;
+}
+
+ContentFilterResult content_filter_attach(WebKitWebView* webview, const std::string& store_dir,
+                                          const std::string& name, const std::string& hash,
+                                          std::shared_ptr<const std::string> rules) {
+#if WEBKIT_CHECK_VERSION(2, 26, 0)
+    if (store_dir.empty()) return ContentFilterResult::NO_STORE;
+    const std::string id = name + '.' + hash;
+    if (view_wants(webview, name, id)) return ContentFilterResult::ATTACHED;
+
+    auto& filters = registry().filters;
+    const std::string key = filter_key(store_dir, id);
+    auto it = filters.find(key);
+    if (it == filters.end() && !rules) return ContentFilterResult::NEEDS_RULES;
+
+    WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(webview);
+    auto& wanted = view_filters(webview);
+    auto current = wanted.find(name);
+    if (current != wanted.end()) {
+        webkit_user_content_manager_remove_filter_by_id(manager, current->second.c_str());
+    }
+    wanted[name] = id;
+
+    LoadedFilter& loaded = it != filters.end() ? it->second : filters[key];
+    if (loaded.filter) {
+        LOGGER_V("content_filter: attaching loaded id=%s webview=%p", id.c_str(), webview);
+        webkit_user_content_manager_add_filter(manager, loaded.filter);
+        return ContentFilterResult::ATTACHED;
+    }
+
+    loaded.waiting.emplace_back(WEBKIT_WEB_VIEW(g_object_ref(webview)), name);
+    if (!loaded.rules) loaded.rules = std::move(rules);
+    if (!loaded.loading) {
+        loaded.loading = true;
+        LOGGER_D("content_filter: loading id=%s dir=%s", id.c_str(), store_dir.c_str());
+        webkit_user_content_filter_store_lookup(store_for(store_dir), id.c_str(), nullptr, lookup_finished,
+                                                new LoadRequest{store_dir, name, id});
+    }
+    return ContentFilterResult::ATTACHED;
+#else
+    (void) webview;
+    (void) store_dir;
+    (void) name;
+    (void) hash;
+    (void) rules;
+    return ContentFilterResult::UNSUPPORTED;
+#endif
+}
+
+void content_filter_detach(WebKitWebView* webview, const std::string& name) {
+#if WEBKIT_CHECK_VERSION(2, 26, 0)
+    auto& wanted = view_filters(webview);
+    auto it = wanted.find(name);
+    if (it == wanted.end()) return;
+
+    LOGGER_V("content_filter: detaching id=%s webview=%p", it->second.c_str(), webview);
+    webkit_user_content_manager_remove_filter_by_id(webkit_web_view_get_user_content_manager(webview),
+                                                    it->second.c_str());
+    wanted.erase(it);
+#else
+    (void) webview;
+    (void) name;
+#endif
+}
+
+void content_filter_copy(WebKitWebView* from, WebKitWebView* to, const std::string& store_dir) {
+#if WEBKIT_CHECK_VERSION(2, 26, 0)
+    WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(to);
+    webkit_user_content_manager_remove_all_filters(manager);
+    auto& wanted = view_filters(to);
+    wanted = view_filters(from);
+
+    auto& filters = registry().filters;
+    for (const auto& [name, id] : wanted) {
+        auto it = filters.find(filter_key(store_dir, id));
+        if (it == filters.end()) continue;
+        if (it->second.filter) {
+            webkit_user_content_manager_add_filter(manager, it->second.filter);
+        } else {
+            it->second.waiting.emplace_back(WEBKIT_WEB_VIEW(g_object_ref(to)), name);
+        }
+    }
+#else
+    (void) from;
+    (void) to;
+    (void) store_dir;
+#endif
+}
+
+} // namespace wvbridge
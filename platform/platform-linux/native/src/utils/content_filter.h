@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <webkit2/webkit2.h>
+
+namespace wvbridge {
+
+// Content-blocking rule lists compiled with WebKitUserContentFilterStore.
+//
+// A list is stored on disk as "<name>.<hash>" in the store directory, so it is
+// compiled once per rule source and later runs only load the compiled form.
+// Loaded filters are kept in memory and shared by every WebView using the same
+// store directory. All functions must run on the GTK thread.
+
+enum class ContentFilterResult {
+    ATTACHED,     // attached now, or once loading or compiling finishes
+    NEEDS_RULES,  // not loaded yet; call again with the rule source
+    UNSUPPORTED,  // WebKitGTK older than 2.26
+    NO_STORE,     // the WebView has no directory to store compiled lists in
+};
+
+// Returns the filter store directory for webview, whose website data lives in
+// data_dir. When data_dir is empty the directory of the WebView's own website
+// data manager is used, or "" when it has none (ephemeral or default storage).
+std::string content_filter_store_dir(WebKitWebView* webview, const std::string& data_dir);
+
+// Attaches the rule list name with the given source hash to webview, replacing
+// an earlier list with the same name. rules may be null while the list is
+// already loaded; otherwise NEEDS_RULES is returned and nothing changes. A list
+// that fails to compile is reported with notify_content_filter_failed_to_jvm.
+ContentFilterResult content_filter_attach(WebKitWebView* webview, const std::string& store_dir,
+                                          const std::string& name, const std::string& hash,
+                                          std::shared_ptr<const std::string> rules);
+
+// Removes the rule list name from webview. Does nothing when it is not attached.
+void content_filter_detach(WebKitWebView* webview, const std::string& name);
+
+// Attaches the lists attached to from, in store_dir, to to as well, replacing
+// the lists to had. to must have its own user content manager.
+void content_filter_copy(WebKitWebView* from, WebKitWebView* to, const std::string& store_dir);
+
+} // namespace wvbridge
@@ -0,0 +1,184 @@
+#include "data_scheme.h"
+
+#include <gio/gio.h>
+#include <glib.h>
+#include <libsoup/soup.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "wvbridge/native_bridge.h"
+#include <wvbridge/logger.h>
+
+namespace wvbridge {
+
+namespace {
+
+constexpr const char* DATA_SCHEME = "wvbridge-data";
+constexpr const char* DATA_SCHEME_HOST = "message";
+constexpr const char* POINTER_KEY = "wvbridge-data-pointer";
+constexpr const char* REGISTERED_KEY = "wvbridge-data-registered";
+
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+
+struct PendingRequest {
+    WebKitURISchemeRequest* request = nullptr;
+    WebKitWebView* webview = nullptr;
+    std::string channel;
+
+    ~PendingRequest() {
+        if (request) g_object_unref(request);
+        if (webview) g_object_unref(webview);
+    }
+};
+
+jlong bound_pointer(WebKitWebView* webview) {
+    if (!webview) return 0;
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(g_object_get_data(G_OBJECT(webview), POINTER_KEY)));
+}
+
+void finish_with_error(WebKitURISchemeRequest* request, const char* message) {
+    LOGGER_W("data_scheme: request failed reason=%s", message);
+    GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_FAILED, message);
+    webkit_uri_scheme_request_finish_error(request, error);
+    g_error_free(error);
+}
+
+void finish_with_status(WebKitURISchemeRequest* request, guint status) {
+    GInputStream* empty = g_memory_input_stream_new();
+    WebKitURISchemeResponse* response = webkit_uri_scheme_response_new(empty, 0);
+    webkit_uri_scheme_response_set_status(response, status, nullptr);
+
+    SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    soup_message_headers_append(headers, "Access-Control-Allow-Origin", "*");
+    soup_message_headers_append(headers, "Access-Control-Allow-Methods", "POST");
+    soup_message_headers_append(headers, "Access-Control-Allow-Headers", "Content-Type");
+    webkit_uri_scheme_response_set_http_headers(response, headers);
+
+    webkit_uri_scheme_request_finish_with_response(request, response);
+    g_object_unref(response);
+    g_object_unref(empty);
+}
+
+void dispatch(const PendingRequest& pending, void* data, gsize size) {
+    const jlong pointer = bound_pointer(pending.webview);
+    if (pointer == 0) {
+        finish_with_error(pending.request, "wvbridge-data: the WebView was closed");
+        return;
+    }
+
+    LOGGER_D("data_scheme: dispatch pointer=%lld channel=%s bytes=%zu",
+             static_cast<long long>(pointer), pending.channel.c_str(), static_cast<size_t>(size));
+    const jboolean handled = notify_binary_message_to_jvm(
+        pointer, pending.channel.c_str(), data, static_cast<jlong>(size)
+    );
+    finish_with_status(pending.request, handled ? 200 : 404);
+}
+
+void body_spliced_cb(GObject* source, GAsyncResult* result, gpointer user_data) {
+    std::unique_ptr<PendingRequest> pending(static_cast<PendingRequest*>(user_data));
+    GError* error = nullptr;
+    const gssize spliced = g_output_stream_splice_finish(G_OUTPUT_STREAM(source), result, &error);
+    if (spliced < 0) {
+        finish_with_error(pending->request, error ? error->message : "wvbridge-data: unable to read request body");
+        if (error) g_error_free(error);
+        g_object_unref(source);
+        return;
+    }
+
+    // The body was read into one contiguous buffer; it is handed to the JVM in place and freed
+    // once the callback returns.
+    GMemoryOutputStream* sink = G_MEMORY_OUTPUT_STREAM(source);
+    const gsize size = g_memory_output_stream_get_data_size(sink);
+    gpointer data = g_memory_output_stream_steal_data(sink);
+    g_object_unref(source);
+
+    dispatch(*pending, data, size);
+    g_free(data);
+}
+
+void data_scheme_request_cb(WebKitURISchemeRequest* request, gpointer) {
+    WebKitWebView* webview = webkit_uri_scheme_request_get_web_view(request);
+    if (bound_pointer(webview) == 0) {
+        finish_with_error(request, "wvbridge-data: request does not belong to a wvbridge WebView");
+        return;
+    }
+
+    const gchar* method = webkit_uri_scheme_request_get_http_method(request);
+    if (g_strcmp0(method, "OPTIONS") == 0) {
+        finish_with_status(request, 204);
+        return;
+    }
+    if (g_strcmp0(method, "POST") != 0) {
+        finish_with_status(request, 405);
+        return;
+    }
+
+    const gchar* uri = webkit_uri_scheme_request_get_uri(request);
+    GUri* parsed = uri ? g_uri_parse(uri, G_URI_FLAGS_NONE, nullptr) : nullptr;
+    std::string channel;
+    if (parsed && g_strcmp0(g_uri_get_host(parsed), DATA_SCHEME_HOST) == 0) {
+        const gchar* path = g_uri_get_path(parsed);
+        if (path && path[0] == '/') channel = path + 1;
+    }
+    if (parsed) g_uri_unref(parsed);
+    if (channel.empty()) {
+        finish_with_status(request, 400);
+        return;
+    }
+
+    auto pending = std::make_unique<PendingRequest>();
+    pending->request = WEBKIT_URI_SCHEME_REQUEST(g_object_ref(request));
+    pending->webview = WEBKIT_WEB_VIEW(g_object_ref(webview));
+    pending->channel = std::move(channel);
+
+    GInputStream* body = webkit_uri_scheme_request_get_http_body(request);
+    if (!body) {
+        dispatch(*pending, nullptr, 0);
+        return;
+    }
+
+    GOutputStream* sink = g_memory_output_stream_new_resizable();
+    g_output_stream_splice_async(
+        sink, body,
+        static_cast<GOutputStreamSpliceFlags>(G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE | G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET),
+        G_PRIORITY_DEFAULT, nullptr, body_spliced_cb, pending.release()
+    );
+    g_object_unref(body);
+}
+
+#endif
+
+} // namespace
+
+bool data_scheme_attach(WebKitWebView* webview, jlong pointer) {
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+    if (!webview) return false;
+
+    WebKitWebContext* context = webkit_web_view_get_context(webview);
+    if (context && !g_object_get_data(G_OBJECT(context), REGISTERED_KEY)) {
+        LOGGER_D("data_scheme: registering scheme=%s context=%p", DATA_SCHEME, context);
+        webkit_web_context_register_uri_scheme(context, DATA_SCHEME, data_scheme_request_cb, nullptr, nullptr);
+        WebKitSecurityManager* security = webkit_web_context_get_security_manager(context);
+        webkit_security_manager_register_uri_scheme_as_secure(security, DATA_SCHEME);
+        webkit_security_manager_register_uri_scheme_as_cors_enabled(security, DATA_SCHEME);
+        g_object_set_data(G_OBJECT(context), REGISTERED_KEY, GINT_TO_POINTER(1));
+    }
+
+    g_object_set_data(G_OBJECT(webview), POINTER_KEY, reinterpret_cast<gpointer>(static_cast<intptr_t>(pointer)));
+    return true;
+#else
+    LOGGER_W("data_scheme: wvbridge-data:// requires WebKitGTK 2.40 or newer; binary messages are disabled");
+    (void) webview;
+    (void) pointer;
+    return false;
+#endif
+}
+
+void data_scheme_detach(WebKitWebView* webview) {
+    if (!webview) return;
+    g_object_set_data(G_OBJECT(webview), POINTER_KEY, nullptr);
+}
+
+} // namespace wvbridge
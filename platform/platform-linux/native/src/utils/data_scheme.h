@@ -0,0 +1,18 @@
+#pragma once
+
+#include <jni.h>
+
+#include <webkit2/webkit2.h>
+
+namespace wvbridge {
+
+// Makes `wvbridge-data://message/<channel>` available to pages in webview. The
+// scheme is registered once per WebKitWebContext; requests are routed to the
+// JVM through the pointer bound here. Must run on the GTK thread.
+bool data_scheme_attach(WebKitWebView* webview, jlong pointer);
+
+// Unbinds webview so in-flight and later requests fail instead of reaching a
+// closed context. Must run on the GTK thread.
+void data_scheme_detach(WebKitWebView* webview);
+
+} // namespace wvbridge
@@ -0,0 +1,321 @@
+#include "prerender.h"
+
+#include <glib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <wvbridge/logger.h>
+
+#include "app_scheme.h"
+#include "content_filter.h"
+#include "data_scheme.h"
+#include "libs_helpers.h"
+#include "webview_lifecycle.h"
+
+namespace wvbridge {
+
+namespace {
+
+struct PrerenderEntry {
+    WebViewContext* ctx = nullptr;
+    jlong id = 0;
+    std::string uri;
+    WebKitWebView* webview = nullptr; // owned reference
+    GtkWidget* offscreen = nullptr;   // owned toplevel hosting webview until it is activated
+    gulong load_failed_handler = 0;
+    guint expiry_source = 0;
+    bool failed = false;
+    // Current history item and length of the visible WebView when the prerender copied its
+    // history; the copy is stale once either changes.
+    WebKitBackForwardListItem* history_item = nullptr; // owned reference, may be null
+    guint history_length = 0;
+
+    ~PrerenderEntry() {
+        if (expiry_source != 0) g_source_remove(expiry_source);
+        if (webview) {
+            if (load_failed_handler != 0) g_signal_handler_disconnect(webview, load_failed_handler);
+            app_scheme_detach(webview);
+            webkit_web_view_stop_loading(webview);
+        }
+        if (offscreen) gtk_widget_destroy(offscreen);
+        if (webview) g_object_unref(webview);
+        if (history_item) g_object_unref(history_item);
+    }
+};
+
+} // namespace
+
+struct PrerenderPool {
+    jlong next_id = 1;
+    std::vector<std::unique_ptr<PrerenderEntry>> entries; // oldest first
+    guint activation_source = 0;
+    std::string pending_uri;
+};
+
+namespace {
+
+jlong context_pointer(WebViewContext* ctx) {
+    return reinterpret_cast<jlong>(ctx);
+}
+
+std::string normalize_uri(const char* value) {
+    std::string result = value != nullptr ? value : "";
+    while (result.size() > 1 && result.back() == '/') result.pop_back();
+    return result;
+}
+
+// Matches both the URI that was requested and the one the prerender ended up at after redirects.
+bool matches(const PrerenderEntry& entry, const std::string& target) {
+    return normalize_uri(entry.uri.c_str()) == target ||
+           normalize_uri(webkit_web_view_get_uri(entry.webview)) == target;
+}
+
+void remove_entry(PrerenderPool& pool, const PrerenderEntry* entry) {
+    pool.entries.erase(
+        std::remove_if(pool.entries.begin(), pool.entries.end(),
+                       [entry](const std::unique_ptr<PrerenderEntry>& it) { return it.get() == entry; }),
+        pool.entries.end()
+    );
+}
+
+bool history_changed(WebViewContext* ctx, const PrerenderEntry& entry) {
+    WebKitBackForwardList* list = webkit_web_view_get_back_forward_list(ctx->webview);
+    return webkit_back_forward_list_get_current_item(list) != entry.history_item ||
+           webkit_back_forward_list_get_length(list) != entry.history_length;
+}
+
+// Failed prerenders are only marked from their own signal handler, and a prerender whose copy of
+// the history no longer matches the visible WebView would lose entries when shown; drop them here.
+void prune(WebViewContext* ctx) {
+    PrerenderPool& pool = *ctx->prerenders;
+    pool.entries.erase(
+        std::remove_if(pool.entries.begin(), pool.entries.end(),
+                       [ctx](const std::unique_ptr<PrerenderEntry>& it) {
+                           if (it->failed) return true;
+                           if (!history_changed(ctx, *it)) return false;
+                           LOGGER_D("prerender: history changed, dropping id=%lld uri=%s",
+                                    (long long)it->id, it->uri.c_str());
+                           return true;
+                       }),
+        pool.entries.end()
+    );
+}
+
+PrerenderEntry* find_live(PrerenderPool& pool, const char* uri) {
+    const std::string target = normalize_uri(uri);
+    for (auto& entry : pool.entries) {
+        if (!entry->failed && matches(*entry, target)) return entry.get();
+    }
+    return nullptr;
+}
+
+gboolean expire_cb(gpointer data) {
+    auto* entry = static_cast<PrerenderEntry*>(data);
+    entry->expiry_source = 0;
+    LOGGER_D("prerender: expired id=%lld uri=%s", (long long)entry->id, entry->uri.c_str());
+    remove_entry(*entry->ctx->prerenders, entry);
+    return G_SOURCE_REMOVE;
+}
+
+gboolean load_failed_cb(WebKitWebView*, WebKitLoadEvent, const gchar* failing_uri, GError* error, gpointer data) {
+    auto* entry = static_cast<PrerenderEntry*>(data);
+    LOGGER_D("prerender: load failed id=%lld uri=%s reason=%s", (long long)entry->id,
+             failing_uri ? failing_uri : "", error ? error->message : "unknown");
+    entry->failed = true;
+    return FALSE;
+}
+
+void prepare_for_window(WebKitWebView* webview) {
+    gtk_widget_set_can_focus(GTK_WIDGET(webview), TRUE);
+    gtk_widget_set_hexpand(GTK_WIDGET(webview), TRUE);
+    gtk_widget_set_vexpand(GTK_WIDGET(webview), TRUE);
+    gtk_widget_set_halign(GTK_WIDGET(webview), GTK_ALIGN_FILL);
+    gtk_widget_set_valign(GTK_WIDGET(webview), GTK_ALIGN_FILL);
+    gtk_widget_add_events(GTK_WIDGET(webview), GDK_BUTTON_PRESS_MASK);
+}
+
+void add_document_start_hooks(WebViewContext* ctx, WebKitUserContentManager* manager) {
+    for (const auto& hook : ctx->document_start_hooks) {
+        if (hook.second) webkit_user_content_manager_add_script(manager, hook.second);
+    }
+}
+
+// Replaces the visible WebView of ctx with the prerendered one. The GtkWindow and its X11
+// embedding stay as they are; only the child widget, its signal handlers and its bindings move.
+void swap_in(WebViewContext* ctx, PrerenderEntry* entry) {
+    PrerenderPool& pool = *ctx->prerenders;
+    auto it = std::find_if(pool.entries.begin(), pool.entries.end(),
+                           [entry](const std::unique_ptr<PrerenderEntry>& item) { return item.get() == entry; });
+    std::unique_ptr<PrerenderEntry> owned = std::move(*it);
+    pool.entries.erase(it);
+
+    WebKitWebView* view = owned->webview;
+    g_signal_handler_disconnect(view, owned->load_failed_handler);
+    owned->load_failed_handler = 0;
+    owned->webview = nullptr;
+    gtk_container_remove(GTK_CONTAINER(owned->offscreen), GTK_WIDGET(view));
+    owned.reset();
+
+    WebKitWebView* old = WEBKIT_WEB_VIEW(g_object_ref(ctx->webview));
+    LOGGER_I("prerender: activating uri=%s old=%p new=%p", webkit_web_view_get_uri(view), old, view);
+    if (ctx->webview_button_press_handler_id != 0) {
+        g_signal_handler_disconnect(old, ctx->webview_button_press_handler_id);
+        ctx->webview_button_press_handler_id = 0;
+    }
+    if (ctx->events) {
+        webview_events_destroy(ctx->events);
+        ctx->events = nullptr;
+    }
+    message_handler_disconnect(ctx);
+    data_scheme_detach(old);
+    app_scheme_detach(old);
+    webkit_web_view_stop_loading(old);
+
+    // Hooks may have been registered or removed since the prerender started.
+    WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(view);
+    webkit_user_content_manager_remove_all_scripts(manager);
+    add_document_start_hooks(ctx, manager);
+    content_filter_copy(old, view, ctx->content_filter_dir);
+    gtk_container_remove(GTK_CONTAINER(ctx->window), GTK_WIDGET(old));
+
+    prepare_for_window(view);
+    gtk_container_add(GTK_CONTAINER(ctx->window), GTK_WIDGET(view));
+    gtk_widget_show(GTK_WIDGET(view));
+    g_object_unref(view); // the window now holds the only reference, as for the initial WebView
+    ctx->webview = view;
+    if (!message_handler_connect(ctx)) LOGGER_E("prerender: failed to register the message handler on the new view");
+    data_scheme_attach(view, context_pointer(ctx));
+    ctx->webview_button_press_handler_id = g_signal_connect(
+        view, "button-press-event", G_CALLBACK(focus_on_button_press_cb), ctx
+    );
+    ctx->events = webview_events_create(view, context_pointer(ctx), &ctx->closing, ctx->crash_recovery);
+    webview_events_report_current_page(ctx->events);
+
+    gtk_widget_destroy(GTK_WIDGET(old));
+    g_object_unref(old);
+}
+
+gboolean activate_idle(gpointer data) {
+    auto* ctx = static_cast<WebViewContext*>(data);
+    PrerenderPool& pool = *ctx->prerenders;
+    pool.activation_source = 0;
+    const std::string uri = std::move(pool.pending_uri);
+    pool.pending_uri.clear();
+    if (ctx->closing.load(std::memory_order_acquire) || !ctx->webview) return G_SOURCE_REMOVE;
+
+    // The navigation was already cancelled; load it normally if the prerender is gone meanwhile.
+    if (!prerender_activate(ctx, uri.c_str())) webkit_web_view_load_uri(ctx->webview, uri.c_str());
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace
+
+jlong prerender_start(WebViewContext* ctx, const std::string& uri, unsigned int max_count, guint ttl_millis) {
+    if (!ctx || !ctx->webview || max_count == 0) return 0;
+    if (!ctx->prerenders) ctx->prerenders = new PrerenderPool();
+    PrerenderPool& pool = *ctx->prerenders;
+    prune(ctx);
+    if (find_live(pool, uri.c_str())) {
+        LOGGER_V("prerender: already prerendering uri=%s", uri.c_str());
+        return 0;
+    }
+    while (pool.entries.size() >= max_count) {
+        LOGGER_D("prerender: evicting oldest uri=%s", pool.entries.front()->uri.c_str());
+        pool.entries.erase(pool.entries.begin());
+    }
+
+    auto entry = std::make_unique<PrerenderEntry>();
+    entry->ctx = ctx;
+    entry->id = pool.next_id++;
+    entry->uri = uri;
+
+    // Its own user content manager carries the hooks and content filters of the visible WebView but
+    // not the bridge message handler, so the hidden page cannot talk to the app yet.
+    WebKitUserContentManager* manager = webkit_user_content_manager_new();
+    add_document_start_hooks(ctx, manager);
+    entry->webview = WEBKIT_WEB_VIEW(g_object_ref_sink(g_object_new(
+        WEBKIT_TYPE_WEB_VIEW,
+        "web-context", webkit_web_view_get_context(ctx->webview),
+        "settings", webkit_web_view_get_settings(ctx->webview),
+        "user-content-manager", manager,
+        nullptr
+    )));
+    g_object_unref(manager);
+    content_filter_copy(ctx->webview, entry->webview, ctx->content_filter_dir);
+
+    // Carry the history over, so going back from the shown page works as after a normal load.
+    WebKitWebViewSessionState* state = webkit_web_view_get_session_state(ctx->webview);
+    webkit_web_view_restore_session_state(entry->webview, state);
+    webkit_web_view_session_state_unref(state);
+    WebKitBackForwardList* history = webkit_web_view_get_back_forward_list(ctx->webview);
+    WebKitBackForwardListItem* current = webkit_back_forward_list_get_current_item(history);
+    entry->history_item = current ? WEBKIT_BACK_FORWARD_LIST_ITEM(g_object_ref(current)) : nullptr;
+    entry->history_length = webkit_back_forward_list_get_length(history);
+
+    // Lay the page out at the size it will be shown at, so activation needs no relayout.
+    entry->offscreen = gtk_offscreen_window_new();
+    gtk_window_set_default_size(GTK_WINDOW(entry->offscreen),
+                                std::max(1, gtk_widget_get_allocated_width(GTK_WIDGET(ctx->webview))),
+                                std::max(1, gtk_widget_get_allocated_height(GTK_WIDGET(ctx->webview))));
+    gtk_container_add(GTK_CONTAINER(entry->offscreen), GTK_WIDGET(entry->webview));
+    gtk_widget_show_all(entry->offscreen);
+
+    app_scheme_bind(entry->webview, context_pointer(ctx));
+    entry->load_failed_handler = g_signal_connect(entry->webview, "load-failed", G_CALLBACK(load_failed_cb), entry.get());
+    entry->expiry_source = g_timeout_add(ttl_millis, expire_cb, entry.get());
+
+    LOGGER_I("prerender: starting id=%lld uri=%s ttl=%ums", (long long)entry->id, uri.c_str(), ttl_millis);
+    webkit_web_view_load_uri(entry->webview, uri.c_str());
+    const jlong id = entry->id;
+    pool.entries.push_back(std::move(entry));
+    return id;
+}
+
+void prerender_cancel(WebViewContext* ctx, jlong id) {
+    if (!ctx || !ctx->prerenders) return;
+    auto& entries = ctx->prerenders->entries;
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [id](const std::unique_ptr<PrerenderEntry>& entry) { return entry->id == id; });
+    if (it == entries.end()) return;
+    LOGGER_D("prerender: cancelled id=%lld uri=%s", (long long)id, (*it)->uri.c_str());
+    entries.erase(it);
+}
+
+bool prerender_activate(WebViewContext* ctx, const char* uri) {
+    if (!ctx || !ctx->prerenders || !ctx->webview || !ctx->window || !uri) return false;
+    prune(ctx);
+    PrerenderEntry* entry = find_live(*ctx->prerenders, uri);
+    if (!entry) return false;
+    swap_in(ctx, entry);
+    return true;
+}
+
+bool prerender_available(jlong pointer, const char* uri) {
+    auto* ctx = reinterpret_cast<WebViewContext*>(static_cast<uintptr_t>(pointer));
+    if (!ctx || !ctx->prerenders || !ctx->webview || !uri) return false;
+    prune(ctx);
+    return find_live(*ctx->prerenders, uri) != nullptr;
+}
+
+bool prerender_activate_later(jlong pointer, const char* uri) {
+    auto* ctx = reinterpret_cast<WebViewContext*>(static_cast<uintptr_t>(pointer));
+    if (!prerender_available(pointer, uri)) return false;
+
+    PrerenderPool& pool = *ctx->prerenders;
+    pool.pending_uri = uri;
+    if (pool.activation_source == 0) pool.activation_source = g_idle_add(activate_idle, ctx);
+    return true;
+}
+
+void prerender_clear(WebViewContext* ctx) {
+    if (!ctx || !ctx->prerenders) return;
+    if (ctx->prerenders->activation_source != 0) g_source_remove(ctx->prerenders->activation_source);
+    LOGGER_D("prerender: clearing %zu prerenders ctx=%p", ctx->prerenders->entries.size(), ctx);
+    delete ctx->prerenders;
+    ctx->prerenders = nullptr;
+}
+
+} // namespace wvbridge
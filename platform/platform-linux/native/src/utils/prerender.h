@@ -0,0 +1,49 @@
+#pragma once
+
+#include <jni.h>
+
+#include <string>
+
+#include <webkit2/webkit2.h>
+
+struct WebViewContext;
+
+namespace wvbridge {
+
+// Hidden WebViews that load predicted navigations of a WebViewContext ahead of
+// time. A prerender shares the web context and settings of the visible WebView
+// and is bound to the same JVM context for custom schemes. It has its own user
+// content manager with the same document-start hooks and content filters but
+// without the bridge message handler, which only moves over when it is shown,
+// and it starts with a copy of the visible WebView's back-forward history. When
+// the visible WebView navigates its main frame to a prerendered URI, the
+// prerender takes its place in the embedded window instead of loading the page
+// again. A prerender is dropped once the visible WebView's history changes. All
+// functions must run on the GTK thread.
+
+// Starts loading uri in a hidden WebView, dropping the oldest prerenders so at
+// most max_count stay alive. The prerender is dropped ttl_millis after it
+// starts unless it has been activated. Returns its id, or 0 when uri is
+// already being prerendered.
+jlong prerender_start(WebViewContext* ctx, const std::string& uri, unsigned int max_count, guint ttl_millis);
+
+// Drops the prerender with the given id. Does nothing when it is gone.
+void prerender_cancel(WebViewContext* ctx, jlong id);
+
+// Swaps the live prerender of uri into the window of ctx. Returns false when
+// there is none.
+bool prerender_activate(WebViewContext* ctx, const char* uri);
+
+// Returns whether uri has a live prerender that prerender_activate_later would
+// swap in. pointer is the handle of the context.
+bool prerender_available(jlong pointer, const char* uri);
+
+// Like prerender_activate, but swaps from an idle callback so it is safe from
+// signal handlers of the visible WebView. pointer is the handle of the
+// context. Returns false when there is no live prerender of uri.
+bool prerender_activate_later(jlong pointer, const char* uri);
+
+// Drops every prerender of ctx and releases the pool.
+void prerender_clear(WebViewContext* ctx);
+
+} // namespace wvbridge
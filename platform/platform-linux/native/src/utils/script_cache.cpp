@@ -0,0 +1,143 @@
+#include "script_cache.h"
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "gtk.h"
+#include <wvbridge/logger.h>
+
+namespace wvbridge {
+
+namespace {
+
+// Entries are evicted once either limit is exceeded; the most recently used
+// entry is always kept even if it alone exceeds the byte budget.
+constexpr std::size_t MAX_ENTRIES = 64;
+constexpr std::size_t MAX_BYTES = 8 * 1024 * 1024;
+
+struct ScriptCache {
+    using Order = std::list<std::string>;
+
+    struct Slot {
+        std::shared_ptr<InternedScript> entry;
+        Order::iterator position;
+    };
+
+    std::mutex mutex;
+    Order order; // front is most recently used
+    std::unordered_map<std::string, Slot> slots;
+    std::size_t bytes = 0;
+};
+
+ScriptCache& cache() {
+    static auto* instance = new ScriptCache(); // intentionally leaked; outlives static destructors
+    return *instance;
+}
+
+void evict_locked(ScriptCache& c) {
+    while (c.order.size() > 1 && (c.order.size() > MAX_ENTRIES || c.bytes > MAX_BYTES)) {
+        auto it = c.slots.find(c.order.back());
+        LOGGER_V("script_cache: evicting key=%s len=%zu", it->first.c_str(), it->second.entry->source.size());
+        c.bytes -= it->second.entry->source.size();
+        c.slots.erase(it);
+        c.order.pop_back();
+    }
+}
+
+} // namespace
+
+std::string UserScriptOptions::signature() const {
+    // Patterns cannot contain '\n', so it separates them unambiguously.
+    std::string out = main_frame_only ? "top" : "all";
+    for (const auto& pattern : allow_list) out.append("\n+").append(pattern);
+    for (const auto& pattern : block_list) out.append("\n-").append(pattern);
+    return out;
+}
+
+WebKitUserScript* new_document_start_user_script(const std::string& source, const UserScriptOptions& options) {
+    auto to_strv = [](const std::vector<std::string>& patterns) {
+        std::vector<const gchar*> strv;
+        if (patterns.empty()) return strv;
+        for (const auto& pattern : patterns) strv.push_back(pattern.c_str());
+        strv.push_back(nullptr);
+        return strv;
+    };
+    const auto allow_list = to_strv(options.allow_list);
+    const auto block_list = to_strv(options.block_list);
+
+    return webkit_user_script_new(
+        source.c_str(),
+        options.main_frame_only ? WEBKIT_USER_CONTENT_INJECT_TOP_FRAME : WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
+        WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
+        allow_list.empty() ? nullptr : allow_list.data(),
+        block_list.empty() ? nullptr : block_list.data()
+    );
+}
+
+InternedScript::~InternedScript() {
+    if (user_scripts.empty()) return;
+
+    // The last reference may be dropped on a JNI thread; WebKit objects are
+    // released on the GTK thread.
+    std::vector<WebKitUserScript*> scripts;
+    for (const auto& it : user_scripts) scripts.push_back(it.second);
+    auto release = [scripts] {
+        for (WebKitUserScript* script : scripts) webkit_user_script_unref(script);
+    };
+    if (gtk_is_gtk_thread()) {
+        release();
+    } else if (!gtk_run_on_thread_async(release)) {
+        LOGGER_W("script_cache: GTK thread stopped, leaking %zu user scripts", scripts.size());
+    }
+}
+
+std::shared_ptr<InternedScript> script_cache_find(const std::string& key) {
+    auto& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    auto it = c.slots.find(key);
+    if (it == c.slots.end()) {
+        LOGGER_V("script_cache: miss key=%s", key.c_str());
+        return nullptr;
+    }
+    c.order.splice(c.order.begin(), c.order, it->second.position);
+    return it->second.entry;
+}
+
+std::shared_ptr<InternedScript> script_cache_put(const std::string& key, std::string source) {
+    auto& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    auto it = c.slots.find(key);
+    if (it != c.slots.end()) {
+        c.order.splice(c.order.begin(), c.order, it->second.position);
+        return it->second.entry;
+    }
+
+    auto entry = std::make_shared<InternedScript>(std::move(source));
+    c.order.push_front(key);
+    c.slots.emplace(key, ScriptCache::Slot{entry, c.order.begin()});
+    c.bytes += entry->source.size();
+    LOGGER_V("script_cache: interned key=%s len=%zu total=%zu", key.c_str(), entry->source.size(), c.bytes);
+
+    evict_locked(c);
+    return entry;
+}
+
+WebKitUserScript* script_cache_user_script(const std::shared_ptr<InternedScript>& entry,
+                                           const UserScriptOptions& options) {
+    auto& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    WebKitUserScript*& script = entry->user_scripts[options.signature()];
+    if (!script) {
+        script = new_document_start_user_script(entry->source, options);
+        LOGGER_V("script_cache: created user script=%p variants=%zu", (void*)script, entry->user_scripts.size());
+    }
+    return webkit_user_script_ref(script);
+}
+
+} // namespace wvbridge
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <webkit2/webkit2.h>
+
+namespace wvbridge {
+
+// Where a document-start script runs. Patterns use WebKit's URL match pattern
+// syntax, e.g. `https://*.example.com/*`.
+struct UserScriptOptions {
+    bool main_frame_only = false;
+    std::vector<std::string> allow_list;
+    std::vector<std::string> block_list;
+
+    // Identifies options that produce interchangeable WebKitUserScript objects.
+    std::string signature() const;
+};
+
+// Creates a document-start WebKitUserScript for source; the caller owns the
+// returned reference.
+WebKitUserScript* new_document_start_user_script(const std::string& source, const UserScriptOptions& options);
+
+// A script source kept in native memory so the JVM can refer to it by key
+// instead of transcoding the same large string on every call.
+struct InternedScript {
+    explicit InternedScript(std::string source) : source(std::move(source)) {}
+    ~InternedScript();
+
+    InternedScript(const InternedScript&) = delete;
+    InternedScript& operator=(const InternedScript&) = delete;
+
+    const std::string source;
+    // Document-start scripts built from source, keyed by UserScriptOptions::signature().
+    // Guarded by the cache mutex.
+    std::map<std::string, WebKitUserScript*> user_scripts;
+};
+
+// Returns the entry for key and marks it most recently used, or nullptr when
+// it has never been interned or has been evicted. Thread-safe.
+std::shared_ptr<InternedScript> script_cache_find(const std::string& key);
+
+// Interns source under key, replacing nothing if the key is already present,
+// and evicts least recently used entries beyond the cache budget. The table
+// is process-wide and shared by every WebView. Thread-safe.
+std::shared_ptr<InternedScript> script_cache_put(const std::string& key, std::string source);
+
+// Returns a new reference to the document-start WebKitUserScript built from
+// entry with options, creating it on first use so hooks with the same source
+// and options share one object across every WebView. Must run on the GTK thread.
+WebKitUserScript* script_cache_user_script(const std::shared_ptr<InternedScript>& entry,
+                                           const UserScriptOptions& options);
+
+} // namespace wvbridge
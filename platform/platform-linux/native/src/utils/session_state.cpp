@@ -0,0 +1,30 @@
+#include "session_state.h"
+
+#include <wvbridge/logger.h>
+
+namespace wvbridge {
+
+GBytes* session_state_save(WebKitWebView* webview) {
+    WebKitWebViewSessionState* state = webkit_web_view_get_session_state(webview);
+    GBytes* bytes = webkit_web_view_session_state_serialize(state);
+    webkit_web_view_session_state_unref(state);
+    LOGGER_D("session_state: saved webview=%p size=%zu", webview, g_bytes_get_size(bytes));
+    return bytes;
+}
+
+void session_state_apply(WebKitWebView* webview, WebKitWebViewSessionState* state) {
+    // Restoring only replaces the back-forward list; nothing is loaded until an item is.
+    webkit_web_view_restore_session_state(webview, state);
+
+    WebKitBackForwardList* list = webkit_web_view_get_back_forward_list(webview);
+    WebKitBackForwardListItem* current = list ? webkit_back_forward_list_get_current_item(list) : nullptr;
+    LOGGER_D("session_state: applied webview=%p uri=%s", webview,
+             current ? webkit_back_forward_list_item_get_uri(current) : "(none)");
+    if (current) {
+        webkit_web_view_go_to_back_forward_list_item(webview, current);
+    } else {
+        webkit_web_view_reload(webview);
+    }
+}
+
+} // namespace wvbridge
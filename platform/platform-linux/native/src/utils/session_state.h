@@ -0,0 +1,15 @@
+#pragma once
+
+#include <webkit2/webkit2.h>
+
+namespace wvbridge {
+
+// Serializes the back-forward list and page state of webview. The caller owns
+// the returned bytes. Must run on the GTK thread.
+GBytes* session_state_save(WebKitWebView* webview);
+
+// Replaces the history of webview with state and loads its current entry, or
+// reloads when state has no current entry. Must run on the GTK thread.
+void session_state_apply(WebKitWebView* webview, WebKitWebViewSessionState* state);
+
+} // namespace wvbridge
@@ -0,0 +1,131 @@
+#include "web_context_pool.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <wvbridge/logger.h>
+
+namespace wvbridge {
+
+namespace {
+
+// Both are borrowed: weak references clear them when the last WebView using
+// them is destroyed. Only touched on the GTK thread.
+WebKitWebsiteDataManager* ephemeral_manager = nullptr;
+std::map<std::string, WebKitWebContext*> ephemeral_contexts; // options_key() -> context
+
+std::string options_key(const WvBridgeLinuxPerformanceSetting& performance) {
+    std::string key;
+    const auto& process_swap = performance.process_swap_on_cross_site_navigation;
+    key += process_swap ? (*process_swap ? "swap" : "noswap") : "default";
+    if (const auto& pressure = performance.memory_pressure) {
+        key += ' ' + std::to_string(pressure->memory_limit_mb) +
+               ' ' + std::to_string(pressure->conservative_threshold) +
+               ' ' + std::to_string(pressure->strict_threshold) +
+               ' ' + std::to_string(pressure->kill_threshold) +
+               ' ' + std::to_string(pressure->poll_interval_seconds);
+    }
+    return key;
+}
+
+WebKitWebsiteDataManager* acquire_ephemeral_manager() {
+    if (ephemeral_manager) return WEBKIT_WEBSITE_DATA_MANAGER(g_object_ref(ephemeral_manager));
+
+    ephemeral_manager = webkit_website_data_manager_new_ephemeral();
+    LOGGER_D("web_context_pool: created ephemeral data manager=%p", ephemeral_manager);
+    g_object_weak_ref(G_OBJECT(ephemeral_manager), [](gpointer, GObject*) {
+        LOGGER_D("web_context_pool: ephemeral data manager released");
+        ephemeral_manager = nullptr;
+    }, nullptr);
+    return ephemeral_manager;
+}
+
+#if WEBKIT_CHECK_VERSION(2, 34, 0)
+WebKitMemoryPressureSettings* new_memory_pressure_settings(const WvBridgeLinuxMemoryPressureSetting& pressure) {
+    WebKitMemoryPressureSettings* settings = webkit_memory_pressure_settings_new();
+    if (pressure.memory_limit_mb > 0) {
+        webkit_memory_pressure_settings_set_memory_limit(settings, pressure.memory_limit_mb);
+    }
+    if (pressure.conservative_threshold > 0) {
+        webkit_memory_pressure_settings_set_conservative_threshold(settings, pressure.conservative_threshold);
+    }
+    if (pressure.strict_threshold > 0) {
+        webkit_memory_pressure_settings_set_strict_threshold(settings, pressure.strict_threshold);
+    }
+    if (pressure.kill_threshold > 0) {
+        webkit_memory_pressure_settings_set_kill_threshold(settings, pressure.kill_threshold);
+    }
+    if (pressure.poll_interval_seconds > 0) {
+        webkit_memory_pressure_settings_set_poll_interval(settings, pressure.poll_interval_seconds);
+    }
+    return settings;
+}
+#endif
+
+} // namespace
+
+bool web_context_needs_construct_options(const WvBridgeLinuxPerformanceSetting& performance) {
+    return performance.process_swap_on_cross_site_navigation.has_value() || performance.memory_pressure.has_value();
+}
+
+WebKitWebContext* web_context_new(WebKitWebsiteDataManager* manager, const WvBridgeLinuxPerformanceSetting& performance) {
+    std::vector<const char*> names;
+    std::vector<GValue> values;
+    auto add = [&names, &values](const char* name, GType type) -> GValue* {
+        names.push_back(name);
+        values.emplace_back(); // value-initialized, i.e. G_VALUE_INIT
+        return g_value_init(&values.back(), type);
+    };
+    // At most three properties; reserving keeps the pointers returned by add() valid.
+    names.reserve(3);
+    values.reserve(3);
+
+    g_value_set_object(add("website-data-manager", WEBKIT_TYPE_WEBSITE_DATA_MANAGER), manager);
+#if WEBKIT_CHECK_VERSION(2, 28, 0)
+    if (const auto& process_swap = performance.process_swap_on_cross_site_navigation) {
+        g_value_set_boolean(add("process-swap-on-cross-site-navigation-enabled", G_TYPE_BOOLEAN), *process_swap);
+    }
+#endif
+#if WEBKIT_CHECK_VERSION(2, 34, 0)
+    if (const auto& pressure = performance.memory_pressure) {
+        g_value_take_boxed(add("memory-pressure-settings", WEBKIT_TYPE_MEMORY_PRESSURE_SETTINGS),
+                           new_memory_pressure_settings(*pressure));
+    }
+#endif
+
+    auto* context = WEBKIT_WEB_CONTEXT(g_object_new_with_properties(
+        WEBKIT_TYPE_WEB_CONTEXT, static_cast<guint>(names.size()), names.data(), values.data()
+    ));
+    for (auto& value : values) g_value_unset(&value);
+    LOGGER_V("web_context_pool: created context=%p manager=%p properties=%zu", context, manager, names.size());
+    return context;
+}
+
+WebKitWebContext* web_context_pool_acquire_ephemeral(const WvBridgeLinuxPerformanceSetting& performance) {
+    const std::string key = options_key(performance);
+    auto it = ephemeral_contexts.find(key);
+    if (it != ephemeral_contexts.end()) {
+        LOGGER_V("web_context_pool: reusing ephemeral context=%p", it->second);
+        return WEBKIT_WEB_CONTEXT(g_object_ref(it->second));
+    }
+
+    WebKitWebsiteDataManager* manager = acquire_ephemeral_manager();
+    if (!manager) return nullptr;
+    WebKitWebContext* context = web_context_new(manager, performance);
+    g_object_unref(manager);
+    if (!context) return nullptr;
+
+    LOGGER_D("web_context_pool: created ephemeral context=%p options=%s", context, key.c_str());
+    auto* slot_key = new std::string(key);
+    ephemeral_contexts[key] = context;
+    g_object_weak_ref(G_OBJECT(context), [](gpointer data, GObject*) {
+        auto* key = static_cast<std::string*>(data);
+        LOGGER_D("web_context_pool: ephemeral context released options=%s", key->c_str());
+        ephemeral_contexts.erase(*key);
+        delete key;
+    }, slot_key);
+    return context;
+}
+
+} // namespace wvbridge
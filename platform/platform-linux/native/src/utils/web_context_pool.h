@@ -0,0 +1,24 @@
+#pragma once
+
+#include <webkit2/webkit2.h>
+
+#include <wvbridge/webview-platform-settings.h>
+
+namespace wvbridge {
+
+// Whether performance sets any option that can only be applied when a web
+// context is constructed, which then needs its own context.
+bool web_context_needs_construct_options(const WvBridgeLinuxPerformanceSetting& performance);
+
+// Creates a web context on manager with the construct-time options from
+// performance. The caller owns the returned reference. Must run on the GTK thread.
+WebKitWebContext* web_context_new(WebKitWebsiteDataManager* manager, const WvBridgeLinuxPerformanceSetting& performance);
+
+// Returns a new reference to the web context shared by every ephemeral WebView
+// created with the same construct-time options. The contexts are built on one
+// ephemeral WebKitWebsiteDataManager, so cookies, storage and caches stay in
+// memory and are dropped once the last ephemeral WebView is gone. Must run on
+// the GTK thread.
+WebKitWebContext* web_context_pool_acquire_ephemeral(const WvBridgeLinuxPerformanceSetting& performance);
+
+} // namespace wvbridge
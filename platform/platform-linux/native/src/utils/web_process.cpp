@@ -0,0 +1,80 @@
+#include "web_process.h"
+
+#include "session_state.h"
+
+#include <wvbridge/logger.h>
+
+namespace wvbridge {
+
+namespace {
+
+constexpr const char* UNLOADED_KEY = "wvbridge-web-process-unloaded";
+
+struct UnloadedState {
+    WebKitWebViewSessionState* session_state = nullptr; // owned
+    WebKitWebView* webview = nullptr;                   // borrowed; owns this state
+    gulong load_changed_handler = 0;
+
+    ~UnloadedState() {
+        if (load_changed_handler != 0) g_signal_handler_disconnect(webview, load_changed_handler);
+        if (session_state) webkit_web_view_session_state_unref(session_state);
+    }
+};
+
+UnloadedState* unloaded_state(WebKitWebView* webview) {
+    return static_cast<UnloadedState*>(g_object_get_data(G_OBJECT(webview), UNLOADED_KEY));
+}
+
+void load_changed_cb(WebKitWebView* webview, WebKitLoadEvent event, gpointer) {
+    if (event != WEBKIT_LOAD_STARTED) return;
+    // Any new load relaunches the web process, so the saved state is stale.
+    LOGGER_D("web_process: load started while unloaded, dropping saved state webview=%p", webview);
+    g_object_set_data(G_OBJECT(webview), UNLOADED_KEY, nullptr);
+}
+
+} // namespace
+
+bool web_process_unload(WebKitWebView* webview) {
+#if WEBKIT_CHECK_VERSION(2, 34, 0)
+    if (!webview) return false;
+    if (unloaded_state(webview)) return true;
+
+    auto* state = new UnloadedState();
+    state->webview = webview;
+    state->session_state = webkit_web_view_get_session_state(webview);
+    // Attach before terminating: the terminated signal handler checks it.
+    g_object_set_data_full(G_OBJECT(webview), UNLOADED_KEY, state,
+                           [](gpointer data) { delete static_cast<UnloadedState*>(data); });
+    LOGGER_I("web_process: unloading webview=%p uri=%s", webview, webkit_web_view_get_uri(webview));
+    webkit_web_view_terminate_web_process(webview);
+    state->load_changed_handler = g_signal_connect(webview, "load-changed", G_CALLBACK(load_changed_cb), nullptr);
+    return true;
+#else
+    (void) webview;
+    return false;
+#endif
+}
+
+bool web_process_restore(WebKitWebView* webview) {
+    UnloadedState* state = webview ? unloaded_state(webview) : nullptr;
+    if (!state) return false;
+
+    WebKitWebViewSessionState* session_state = state->session_state;
+    state->session_state = nullptr;
+    g_object_set_data(G_OBJECT(webview), UNLOADED_KEY, nullptr);
+
+    LOGGER_I("web_process: restoring webview=%p", webview);
+    if (session_state) {
+        session_state_apply(webview, session_state);
+        webkit_web_view_session_state_unref(session_state);
+    } else {
+        webkit_web_view_reload(webview);
+    }
+    return true;
+}
+
+bool web_process_is_unloaded(WebKitWebView* webview) {
+    return webview && unloaded_state(webview);
+}
+
+} // namespace wvbridge
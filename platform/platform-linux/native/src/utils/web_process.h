@@ -0,0 +1,20 @@
+#pragma once
+
+#include <webkit2/webkit2.h>
+
+namespace wvbridge {
+
+// Terminates the web process of webview to free its memory, keeping the
+// session state so web_process_restore can bring the page back. A WebView that
+// starts another load in the meantime simply drops the saved state. Returns
+// false when WebKitGTK is older than 2.34. Must run on the GTK thread.
+bool web_process_unload(WebKitWebView* webview);
+
+// Reloads a WebView unloaded by web_process_unload from its saved session
+// state. Returns false when it was not unloaded. Must run on the GTK thread.
+bool web_process_restore(WebKitWebView* webview);
+
+// Whether webview has been unloaded and not restored or navigated since.
+bool web_process_is_unloaded(WebKitWebView* webview);
+
+} // namespace wvbridge
@@ -3,12 +3,17 @@
 #include <glib.h>
 
 #include <algorithm>
+#include <deque>
 #include <string>
 #include <utility>
 
 #include "wvbridge/native_bridge.h"
 #include <wvbridge/logger.h>
 
+#include "prerender.h"
+#include "session_state.h"
+#include "web_process.h"
+
 namespace wvbridge {
 
 struct WebViewEvents {
@@ -27,6 +32,19 @@ struct WebViewEvents {
 
     bool last_load_failed = false;
     std::string last_error_reason;
+
+    // A link click to a prerendered URI is only known to target the main frame once its load
+    // starts, since policy decisions are also made for subframes. The load is then cancelled and
+    // the prerender swapped in; events of the cancelled load are not reported.
+    std::string prerender_candidate;
+    bool prerender_swapping = false;
+
+    std::optional<WvBridgeLinuxCrashRecoverySetting> crash_recovery;
+    std::deque<gint64> recent_crashes; // monotonic times of recoveries within the period
+    guint recovery_source = 0;         // idle source reloading the view after a crash
+    gint64 recovering_since = 0;       // 0 unless waiting for the restored page to load
+    int recovering_attempt = 0;
+    std::string recovering_cause;
 };
 
 namespace {
@@ -141,6 +159,59 @@ void url_changed_cb(WebKitWebView* webview, GParamSpec*, gpointer user_data) {
     notify_url_change_to_jvm(events->pointer, webkit_web_view_get_uri(webview));
 }
 
+void finish_recovery(WebViewEvents* events, bool success) {
+    const gint64 duration_millis = (g_get_monotonic_time() - events->recovering_since) / 1000;
+    events->recovering_since = 0;
+    LOGGER_I("finish_recovery: cause=%s attempt=%d duration=%lldms success=%d", events->recovering_cause.c_str(),
+             events->recovering_attempt, (long long)duration_millis, success ? 1 : 0);
+    notify_web_process_recovered_to_jvm(
+        events->pointer,
+        events->recovering_cause.c_str(),
+        events->recovering_attempt,
+        duration_millis,
+        success ? JNI_TRUE : JNI_FALSE
+    );
+}
+
+gboolean recover_web_process_idle(gpointer user_data) {
+    auto* events = static_cast<WebViewEvents*>(user_data);
+    events->recovery_source = 0;
+    if (is_closing(events)) return G_SOURCE_REMOVE;
+
+    // The back-forward list lives in the UI process and survives the crash, as do the user content
+    // manager's document-start scripts and message handlers, which WebKit installs into the new web
+    // process. Restoring the session state brings back scroll positions and form state as well.
+    WebKitWebViewSessionState* state = webkit_web_view_get_session_state(events->webview);
+    session_state_apply(events->webview, state);
+    webkit_web_view_session_state_unref(state);
+    return G_SOURCE_REMOVE;
+}
+
+// Schedules an in-place reload after the web process died with cause. Returns false when crash
+// recovery is off or the view has already been recovered max_attempts times within the period.
+bool try_recover_web_process(WebViewEvents* events, const char* cause) {
+    if (!events->crash_recovery) return false;
+
+    const gint64 now = g_get_monotonic_time();
+    const gint64 period = static_cast<gint64>(events->crash_recovery->period_seconds) * G_USEC_PER_SEC;
+    auto& crashes = events->recent_crashes;
+    while (!crashes.empty() && now - crashes.front() >= period) crashes.pop_front();
+    if (crashes.size() >= events->crash_recovery->max_attempts) {
+        LOGGER_W("try_recover_web_process: %zu recoveries within %us, giving up",
+                 crashes.size(), events->crash_recovery->period_seconds);
+        return false;
+    }
+    crashes.push_back(now);
+
+    events->recovering_since = now;
+    events->recovering_attempt = static_cast<int>(crashes.size());
+    events->recovering_cause = cause;
+    LOGGER_I("try_recover_web_process: cause=%s attempt=%d", cause, events->recovering_attempt);
+    // Reload once the termination has been fully handled rather than from inside the signal.
+    if (events->recovery_source == 0) events->recovery_source = g_idle_add(recover_web_process_idle, events);
+    return true;
+}
+
 void load_changed_cb(WebKitWebView* webview, WebKitLoadEvent load_event, gpointer user_data) {
     auto* events = static_cast<WebViewEvents*>(user_data);
     LOGGER_I("load_changed_cb: webview=%p, load_event=%d, events=%p", webview, (int)load_event, events);
@@ -149,6 +220,23 @@ void load_changed_cb(WebKitWebView* webview, WebKitLoadEvent load_event, gpointe
         return;
     }
 
+    if (load_event == WEBKIT_LOAD_STARTED) {
+        events->prerender_swapping = false;
+        const std::string candidate = std::move(events->prerender_candidate);
+        events->prerender_candidate.clear();
+        if (!candidate.empty() &&
+            normalize_url_for_compare(webkit_web_view_get_uri(webview)) == normalize_url_for_compare(candidate.c_str()) &&
+            prerender_activate_later(events->pointer, candidate.c_str())) {
+            LOGGER_I("load_changed_cb: main frame link has a prerender, swapping it in uri=%s", candidate.c_str());
+            events->prerender_swapping = true;
+            webkit_web_view_stop_loading(webview);
+            return;
+        }
+    } else if (events->prerender_swapping) {
+        LOGGER_V("load_changed_cb: load replaced by a prerender, suppressed");
+        return;
+    }
+
     switch (load_event) {
         case WEBKIT_LOAD_STARTED:
             LOGGER_V("load_changed_cb: WEBKIT_LOAD_STARTED, uri=%s", webkit_web_view_get_uri(webview));
@@ -174,6 +262,7 @@ void load_changed_cb(WebKitWebView* webview, WebKitLoadEvent load_event, gpointe
                 success ? JNI_TRUE : JNI_FALSE,
                 success ? nullptr : events->last_error_reason.c_str()
             );
+            if (events->recovering_since != 0) finish_recovery(events, success);
             break;
         }
         case WEBKIT_LOAD_REDIRECTED:
@@ -189,6 +278,7 @@ void progress_changed_cb(GObject* object, GParamSpec*, gpointer user_data) {
         LOGGER_W("progress_changed_cb: null events or closing, aborting");
         return;
     }
+    if (events->prerender_swapping) return;
     float progress = clamp01(webkit_web_view_get_estimated_load_progress(WEBKIT_WEB_VIEW(object)));
     LOGGER_V("progress_changed_cb: notifying progress=%.2f", progress);
     notify_page_loading_progress_to_jvm(
@@ -210,6 +300,10 @@ gboolean load_failed_cb(
         LOGGER_W("load_failed_cb: null events or closing, aborting");
         return FALSE;
     }
+    if (events->prerender_swapping) {
+        LOGGER_V("load_failed_cb: load replaced by a prerender, suppressed");
+        return FALSE;
+    }
 
     events->last_load_failed = true;
     std::string reason = "webkitgtk.load-failed";
@@ -234,7 +328,7 @@ gboolean load_failed_cb(
 }
 
 void web_process_terminated_cb(
-    WebKitWebView*,
+    WebKitWebView* webview,
     WebKitWebProcessTerminationReason reason,
     gpointer user_data
 ) {
@@ -244,6 +338,10 @@ void web_process_terminated_cb(
         LOGGER_W("web_process_terminated_cb: null events or closing, aborting");
         return;
     }
+    if (reason == WEBKIT_WEB_PROCESS_TERMINATED_BY_API && web_process_is_unloaded(webview)) {
+        LOGGER_V("web_process_terminated_cb: unloaded to save memory, not a fatal error");
+        return;
+    }
 
     const char* cause = nullptr;
     switch (reason) {
@@ -261,6 +359,7 @@ void web_process_terminated_cb(
             break;
     }
     LOGGER_V("web_process_terminated_cb: cause=%s", cause ? cause : "null");
+    if (cause && try_recover_web_process(events, cause)) return;
     notify_webview_fatal_error_to_jvm(events->pointer, cause);
 }
 
@@ -322,6 +421,15 @@ gboolean decide_policy_cb(
             if (request && apply_navigation_interceptor(events, decision, webkit_uri_request_get_uri(request))) {
                 return TRUE;
             }
+            const char* method = request ? webkit_uri_request_get_http_method(request) : nullptr;
+            if (request &&
+                webkit_navigation_action_get_navigation_type(action) == WEBKIT_NAVIGATION_TYPE_LINK_CLICKED &&
+                (method == nullptr || g_strcmp0(method, "GET") == 0) &&
+                prerender_available(events->pointer, webkit_uri_request_get_uri(request))) {
+                LOGGER_V("decide_policy_cb: link has a prerender, swapping it in if the main frame loads it uri=%s",
+                         webkit_uri_request_get_uri(request));
+                events->prerender_candidate = webkit_uri_request_get_uri(request);
+            }
         }
         webkit_policy_decision_use(decision);
         return TRUE;
@@ -335,7 +443,8 @@ gboolean decide_policy_cb(
 WebViewEvents* webview_events_create(
     WebKitWebView* webview,
     jlong pointer,
-    const std::atomic_bool* closing
+    const std::atomic_bool* closing,
+    const std::optional<WvBridgeLinuxCrashRecoverySetting>& crash_recovery
 ) {
     LOGGER_I("webview_events_create: webview=%p, pointer=%ld", webview, pointer);
     if (!webview) {
@@ -347,6 +456,7 @@ WebViewEvents* webview_events_create(
     events->webview = webview;
     events->pointer = pointer;
     events->closing = closing;
+    events->crash_recovery = crash_recovery;
     events->back_forward_list = webkit_web_view_get_back_forward_list(webview);
 
     LOGGER_V("webview_events_create: connecting signals");
@@ -377,6 +487,28 @@ WebViewEvents* webview_events_create(
     return events;
 }
 
+void webview_events_report_current_page(WebViewEvents* events) {
+    LOGGER_I("webview_events_report_current_page: events=%p", events);
+    if (!events || !events->webview || is_closing(events)) {
+        LOGGER_W("webview_events_report_current_page: null events/webview or closing, aborting");
+        return;
+    }
+
+    const char* uri = webkit_web_view_get_uri(events->webview);
+    notify_url_change_to_jvm(events->pointer, uri);
+    notify_page_loading_start_to_jvm(events->pointer, uri);
+    if (webkit_web_view_is_loading(events->webview)) {
+        LOGGER_V("webview_events_report_current_page: still loading, remaining events follow from signals");
+        notify_page_loading_progress_to_jvm(
+            events->pointer,
+            clamp01(webkit_web_view_get_estimated_load_progress(events->webview))
+        );
+        return;
+    }
+    notify_page_loading_progress_to_jvm(events->pointer, 1.0f);
+    notify_page_loading_end_to_jvm(events->pointer, JNI_TRUE, nullptr);
+}
+
 void webview_events_destroy(WebViewEvents* events) {
     LOGGER_I("webview_events_destroy: events=%p", events);
     if (!events) {
@@ -398,6 +530,10 @@ void webview_events_destroy(WebViewEvents* events) {
             if (handler != 0) g_signal_handler_disconnect(events->webview, handler);
         }
     }
+    if (events->recovery_source != 0) {
+        LOGGER_V("webview_events_destroy: removing pending crash recovery");
+        g_source_remove(events->recovery_source);
+    }
     if (events->back_forward_list && events->history_changed != 0) {
         LOGGER_V("webview_events_destroy: disconnecting back_forward_list signal handler");
         g_signal_handler_disconnect(events->back_forward_list, events->history_changed);
@@ -3,8 +3,10 @@
 #include <jni.h>
 
 #include <atomic>
+#include <optional>
 
 #include <webkit2/webkit2.h>
+#include <wvbridge/webview-platform-settings.h>
 
 namespace wvbridge {
 
@@ -13,9 +15,14 @@ struct WebViewEvents;
 WebViewEvents* webview_events_create(
     WebKitWebView* webview,
     jlong pointer,
-    const std::atomic_bool* closing
+    const std::atomic_bool* closing,
+    const std::optional<WvBridgeLinuxCrashRecoverySetting>& crash_recovery
 );
 
+// Reports the page webview already shows to the JVM as if it had just been
+// loaded. Used when a prerendered WebView replaces the visible one.
+void webview_events_report_current_page(WebViewEvents* events);
+
 void webview_events_destroy(WebViewEvents* events);
 
 } // namespace wvbridge
@@ -1,6 +1,7 @@
 #include "webview_lifecycle.h"
 
 #include <mutex>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -10,7 +11,10 @@
 #include <wvbridge/javascript.h>
 #include <wvbridge/logger.h>
 
+#include "app_scheme.h"
+#include "data_scheme.h"
 #include "gtk.h"
+#include "prerender.h"
 #include "webview_context.h"
 #include "webview_events.h"
 
@@ -33,6 +37,45 @@ void disconnect_signal_if_present(gpointer instance, gulong& handler_id, const c
     handler_id = 0;
 }
 
+void wvbridge_script_message_received(
+    WebKitUserContentManager*,
+    WebKitJavascriptResult* result,
+    gpointer user_data
+) {
+    auto* ctx = static_cast<WebViewContext*>(user_data);
+    LOGGER_V("webmessage.receive: entry ctx=%p result=%p closing=%d",
+             ctx, result,
+             ctx && ctx->closing.load(std::memory_order_acquire) ? 1 : 0);
+    if (!ctx || !result) {
+        LOGGER_W("webmessage.receive: missing context or result ctx=%p result=%p", ctx, result);
+        return;
+    }
+    if (ctx->closing.load(std::memory_order_acquire)) {
+        LOGGER_V("webmessage.receive: context closing; callback suppressed ctx=%p", ctx);
+        return;
+    }
+
+    JSCValue* value = webkit_javascript_result_get_js_value(result);
+    if (!value || jsc_value_is_undefined(value) || jsc_value_is_null(value)) {
+        LOGGER_D("webmessage.receive: phase=dispatch-empty ctx=%p value=%p", ctx, value);
+        wvbridge::dispatch_web_message_to_java(
+            ctx->web_message_handlers_mutex, ctx->web_message_handlers, ""
+        );
+        LOGGER_V("webmessage.receive: empty message dispatched ctx=%p", ctx);
+        return;
+    }
+
+    gchar* string_value = jsc_value_to_string(value);
+    std::string message = string_value ? string_value : "";
+    LOGGER_D("webmessage.receive: phase=dispatch ctx=%p bytes=%zu preview=%.100s",
+             ctx, message.size(), message.c_str());
+    if (string_value) g_free(string_value);
+    wvbridge::dispatch_web_message_to_java(
+        ctx->web_message_handlers_mutex, ctx->web_message_handlers, message.c_str()
+    );
+    LOGGER_V("webmessage.receive: dispatch complete ctx=%p bytes=%zu", ctx, message.size());
+}
+
 } // namespace
 
 bool lifecycle_register(WebViewContext* ctx) {
@@ -117,6 +160,37 @@ bool lifecycle_shutdown_requested() {
     return g_shutdown_requested;
 }
 
+bool message_handler_connect(WebViewContext* ctx) {
+    WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(ctx->webview);
+    if (!manager || !webkit_user_content_manager_register_script_message_handler(manager, "wvbridge")) {
+        LOGGER_E("webmessage.connect: unable to register handler ctx=%p manager=%p", ctx, manager);
+        return false;
+    }
+    ctx->web_message_handler_id = g_signal_connect(
+        manager, "script-message-received::wvbridge",
+        G_CALLBACK(wvbridge_script_message_received), ctx
+    );
+    LOGGER_V("webmessage.connect: ctx=%p manager=%p handler_id=%lu",
+             ctx, manager, static_cast<unsigned long>(ctx->web_message_handler_id));
+    return true;
+}
+
+void message_handler_disconnect(WebViewContext* ctx) {
+    if (!ctx->webview) {
+        ctx->web_message_handler_id = 0;
+        return;
+    }
+
+    WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(ctx->webview);
+    LOGGER_V("webmessage.disconnect: user-content-manager=%p message_handler_id=%lu",
+             manager, static_cast<unsigned long>(ctx->web_message_handler_id));
+    disconnect_signal_if_present(manager, ctx->web_message_handler_id, "script-message-received");
+    if (manager) {
+        webkit_user_content_manager_unregister_script_message_handler(manager, "wvbridge");
+        LOGGER_V("webmessage.disconnect: script message handler unregistered name=wvbridge");
+    }
+}
+
 bool destroy_webview_on_gtk_thread(WebViewContext* ctx) {
     LOGGER_I("webview.destroy: begin ctx=%p gtk_thread=%d", ctx, gtk_is_gtk_thread() ? 1 : 0);
     if (!ctx) {
@@ -133,18 +207,14 @@ bool destroy_webview_on_gtk_thread(WebViewContext* ctx) {
     disconnect_signal_if_present(ctx->window, ctx->window_button_press_handler_id, "window-button-press");
     disconnect_signal_if_present(ctx->webview, ctx->webview_button_press_handler_id, "webview-button-press");
 
+    message_handler_disconnect(ctx);
+
+    prerender_clear(ctx);
     if (ctx->webview) {
-        WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(ctx->webview);
-        LOGGER_V("webview.destroy: user-content-manager=%p message_handler_id=%lu",
-                 manager, static_cast<unsigned long>(ctx->web_message_handler_id));
-        disconnect_signal_if_present(manager, ctx->web_message_handler_id, "script-message-received");
-        if (manager) {
-            webkit_user_content_manager_unregister_script_message_handler(manager, "wvbridge");
-            LOGGER_V("webview.destroy: script message handler unregistered name=wvbridge");
-        }
-    } else {
-        ctx->web_message_handler_id = 0;
+        data_scheme_detach(ctx->webview);
+        app_scheme_detach(ctx->webview);
     }
+    app_scheme_release(reinterpret_cast<jlong>(ctx));
 
     if (ctx->events) {
         LOGGER_V("webview.destroy: destroying event bridge events=%p", ctx->events);
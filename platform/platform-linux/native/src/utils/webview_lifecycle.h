@@ -28,6 +28,14 @@ bool lifecycle_finish_close(const CloseTicket& ticket);
 
 bool lifecycle_shutdown_requested();
 
+// Registers the "wvbridge" script message handler on the user content manager
+// of ctx->webview and routes its messages to the JVM handlers of ctx. Must run
+// on the GTK thread.
+bool message_handler_connect(WebViewContext* ctx);
+
+// Undoes message_handler_connect for ctx->webview. Must run on the GTK thread.
+void message_handler_disconnect(WebViewContext* ctx);
+
 // Must run on the GTK thread. It never obtains JNIEnv and never invokes JVM
 // callbacks. Returns false only if the context was already structurally empty.
 bool destroy_webview_on_gtk_thread(WebViewContext* ctx);
@@ -20,13 +20,17 @@ NSString *jstring_to_nsstring(JNIEnv *env, jstring value) {
         LOGGER_V("jstring_to_nsstring: value is null");
         return nil;
     }
-    const char *chars = env->GetStringUTFChars(value, nullptr);
+    // GetStringUTFChars yields modified UTF-8, which NSString rejects for supplementary
+    // characters; the UTF-16 contents map onto unichar directly.
+    const jsize length = env->GetStringLength(value);
+    const jchar *chars = env->GetStringChars(value, nullptr);
     if (!chars) {
-        LOGGER_V("jstring_to_nsstring: GetStringUTFChars returned null");
+        LOGGER_V("jstring_to_nsstring: GetStringChars returned null");
         return nil;
     }
-    NSString *result = [NSString stringWithUTF8String:chars] ?: @"";
-    env->ReleaseStringUTFChars(value, chars);
+    NSString *result = [NSString stringWithCharacters:reinterpret_cast<const unichar *>(chars)
+                                               length:static_cast<NSUInteger>(length)];
+    env->ReleaseStringChars(value, chars);
     return result;
 }
 
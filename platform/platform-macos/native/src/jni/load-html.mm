@@ -0,0 +1,47 @@
+#import "javascript-helpers.h"
+
+API_EXPORT(void, loadHtml, jlong handle, jstring html, jstring baseUrl) {
+    LOGGER_I("loadHtml: handle=%lld", (long long) handle);
+    if (handle == 0) {
+        LOGGER_W("loadHtml: handle is null, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "handle is null");
+        return;
+    }
+    if (html == nullptr) {
+        LOGGER_W("loadHtml: html is null, throwing NPE");
+        throw_jni_exception(env, "java/lang/NullPointerException", "html is null");
+        return;
+    }
+
+    NSString *content = jstring_to_nsstring(env, html);
+    if (content == nil) {
+        LOGGER_W("loadHtml: html could not be read, aborting");
+        return;
+    }
+
+    NSURL *base = nil;
+    if (baseUrl != nullptr) {
+        NSString *nativeBase = jstring_to_nsstring(env, baseUrl);
+        if (nativeBase == nil) {
+            LOGGER_W("loadHtml: baseUrl could not be read, aborting");
+            return;
+        }
+        base = [NSURL URLWithString:nativeBase];
+    }
+    LOGGER_V("loadHtml: length=%lu baseUrl=%s", (unsigned long) [content length],
+             base ? [[base absoluteString] UTF8String] : "");
+
+    auto *ctx = (WebViewContext *) (uintptr_t) handle;
+    LOGGER_V("loadHtml: ctx=%p", (void *) ctx);
+    if (!ctx) {
+        LOGGER_W("loadHtml: ctx is null after cast, aborting");
+        return;
+    }
+
+    runOnMainAsync(^{
+        LOGGER_V("loadHtml: loading on main thread");
+        if (!ctx) return;
+
+        [ctx->webView loadHTMLString:content baseURL:base];
+    });
+}
@@ -6,13 +6,16 @@
 std::wstring jstring_to_wstring(JNIEnv *env, jstring value) {
     LOGGER_V("jstring_to_wstring: value=%p", value);
     if (!value) return L"";
-    const char *chars = env->GetStringUTFChars(value, nullptr);
+    // Java strings are already UTF-16; going through GetStringUTFChars would mangle supplementary
+    // characters, which modified UTF-8 encodes as surrogate pairs.
+    const jsize length = env->GetStringLength(value);
+    const jchar *chars = env->GetStringChars(value, nullptr);
     if (!chars) {
-        LOGGER_V("jstring_to_wstring: GetStringUTFChars returned null");
+        LOGGER_V("jstring_to_wstring: GetStringChars returned null");
         return L"";
     }
-    std::wstring result = utf8_to_wstring(chars);
-    env->ReleaseStringUTFChars(value, chars);
+    std::wstring result(reinterpret_cast<const wchar_t *>(chars), static_cast<size_t>(length));
+    env->ReleaseStringChars(value, chars);
     return result;
 }
 
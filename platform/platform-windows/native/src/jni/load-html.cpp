@@ -0,0 +1,55 @@
+#include "javascript-helpers.h"
+
+// WebView2 has no base URL for string content; NavigateToString pages always run at about:blank,
+// so baseUrl is ignored here.
+API_EXPORT(void, loadHtml, jlong handle, jstring html, jstring baseUrl) {
+    LOGGER_I("loadHtml: handle=%lld html=%p baseUrl=%p", (long long)handle, html, baseUrl);
+    if (handle == 0) {
+        LOGGER_E("loadHtml: handle is null, JNI exception will be set");
+        throw_jni_exception(env, "java/lang/NullPointerException", "handle is null");
+        return;
+    }
+    if (!html) {
+        LOGGER_E("loadHtml: html is null, JNI exception will be set");
+        throw_jni_exception(env, "java/lang/NullPointerException", "html is null");
+        return;
+    }
+
+    auto *ctx = reinterpret_cast<WebViewContext *>(handle);
+    LOGGER_V("loadHtml: context=%p", ctx);
+    if (!ctx || !ctx->thread) {
+        LOGGER_W("loadHtml: context or thread is null, aborting");
+        return;
+    }
+
+    std::wstring whtml = jstring_to_wstring(env, html);
+    if (env->ExceptionCheck()) {
+        LOGGER_W("loadHtml: html could not be read, aborting");
+        return;
+    }
+    LOGGER_V("loadHtml: html length=%zu", whtml.size());
+
+    HRESULT hr = S_OK;
+    LOGGER_V("loadHtml: dispatching NavigateToString to webview thread");
+    webview2_thread_run_sync(ctx->thread, [ctx, &whtml, &hr] {
+        if (!ctx || ctx->closing.load(std::memory_order_acquire)) {
+            LOGGER_V("loadHtml: ctx closing or null, aborting");
+            hr = E_FAIL;
+            return;
+        }
+        if (!ctx->webview) {
+            LOGGER_V("loadHtml: webview is null, aborting");
+            hr = E_FAIL;
+            return;
+        }
+        LOGGER_V("loadHtml: calling ICoreWebView2::NavigateToString");
+        hr = ctx->webview->NavigateToString(whtml.c_str());
+        LOGGER_V("loadHtml: NavigateToString returned hr=0x%lx", (unsigned long)hr);
+    });
+
+    if (FAILED(hr)) {
+        LOGGER_E("loadHtml: NavigateToString failed, hr=0x%lx", (unsigned long)hr);
+        std::string message = "WebView2 NavigateToString failed [HRESULT=" + format_hresult(hr) + "]";
+        throw_jni_exception(env, "java/lang/RuntimeException", message.c_str());
+    }
+}
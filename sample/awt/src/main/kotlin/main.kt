@@ -10,6 +10,9 @@ import java.time.LocalDateTime
 import java.time.format.DateTimeFormatter
 import javax.swing.*
 import top.kagg886.wvbridge.config.currentJvmPlatformSetting
+import top.kagg886.wvbridge.config.internal.NativeLinuxCacheModel
+import top.kagg886.wvbridge.config.internal.NativeLinuxHardwareAcceleration
+import top.kagg886.wvbridge.config.internal.NativeLinuxWebsiteDataStore
 import top.kagg886.wvbridge.config.internal.NativeLinuxWebViewPlatformSetting
 import top.kagg886.wvbridge.config.internal.NativeMacOSWebViewPlatformSetting
 import top.kagg886.wvbridge.config.internal.NativeMacOSWebViewWebsiteDataStore
@@ -53,6 +56,19 @@ private class BrowserPane(
                 userAgent = "wvbridge",
                 dataDir = path.resolve("data").absolutePathString(),
                 cacheDir = path.resolve("cache").absolutePathString(),
+                websiteDataStore = NativeLinuxWebsiteDataStore.DEFAULT,
+                cacheModel = NativeLinuxCacheModel.DEFAULT,
+                hardwareAcceleration = NativeLinuxHardwareAcceleration.DEFAULT,
+                pageCache = null,
+                smoothScrolling = null,
+                webGL = null,
+                media = null,
+                javaScriptCanOpenWindows = null,
+                dnsPrefetching = null,
+                processSwapOnCrossSiteNavigation = null,
+                memoryPressure = null,
+                suspendHiddenAfterMillis = null,
+                crashRecovery = null,
             )
 
             JvmTarget.MACOS -> NativeMacOSWebViewPlatformSetting(
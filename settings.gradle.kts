@@ -34,6 +34,7 @@ dependencyResolutionManagement {
 }
 include(":core")
 include(":jsbridge")
+include(":jsbridge-ksp")
 
 include(":platform:platform-windows")
 include(":platform:platform-linux")